@@ -1,115 +1,178 @@
 /**
  * @file main.cpp
  * @brief Simulación de partículas con efectos visuales psicodélicos
- * 
+ *
  * Crea una ventana con una simulación de partículas y un efecto fractal.
- * Usa SDL para gráficos y OpenMP para paralelización.
+ * Usa SDL para gráficos y OpenMP para paralelización. Con --headless
+ * (o al compilar con PARALELA_HEADLESS) ejecuta el modo de medición
+ * sin ventana.
  */
 
-#include "source/renderer.hpp"
+#include "source/pipeline.hpp"
+#include "source/benchmark.hpp"
+#include "source/snapshot.hpp"
+#include "source/checks.hpp"
 #include "source/include.hpp"
 
+#ifndef PARALELA_HEADLESS
 // Configuración de la ventana y simulación
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
-const uint16_t RESX = 1000, RESY = 600;
-const uint16_t numCircles = 2048;
+SDL_Texture* texture = nullptr;
+Scene scene;
 
-// Variables de tiempo
-double update_time = 0.2, window_time = 0, delta_time = 0, run_time = 0;
-clock_t last_time = 0, current_time = 0;
+// Variables de tiempo (segundos de reloj de pared)
+double update_time = 0.2, window_time = 0, delta_time = 0;
+double last_time = 0, current_time = 0;
+
+#ifdef PARALELA_TRACE
+// Indicador de tiempos de cuadro (F3 lo muestra u oculta)
+FrameStats frameStats;
+bool showOverlay = true;
+#endif
 
 // Declaraciones de funciones
 void init(const uint16_t RESX, const uint16_t RESY);
-void render(vector<Circle>& circles);
+void render(FramePipeline& pipeline);
+#endif
+
+/**
+ * Escribe la traza de zonas si se pidió con --trace
+ */
+void writeTrace(const BenchmarkOptions& options) {
+#ifdef PARALELA_TRACE
+    if (!options.tracePath.empty() && !writeChromeTrace(options.tracePath)) {
+        cerr << "No se pudo escribir " << options.tracePath << endl;
+    }
+#endif
+}
 
 /**
  * Función principal del programa
  */
 int main(int argc, char* argv[]) {
-    init(RESX, RESY);
-    
+    BenchmarkOptions options;
+    bool headless = false;
+    try {
+        headless = parseBenchmarkOptions(argc, argv, options);
+    }
+    catch (const std::exception& error) {
+        cerr << error.what() << "\n" << benchmarkUsage();
+        return 1;
+    }
+
+    if (headless) {
+        int status = 1;
+        try {
+            if (!options.check.empty()) status = runChecks(options);
+            else status = options.exportPath.empty() ? runBenchmark(options) : runExport(options);
+        }
+        catch (const std::exception& error) {
+            cerr << error.what() << endl;
+        }
+        writeTrace(options);
+        return status;
+    }
+
+#ifndef PARALELA_HEADLESS
+    // Misma escena que el modo sin ventana; la ventana toma el tamaño del búfer
+    scene.fractal.adaptive = true;
+    try {
+        setupScene(scene, options);
+    }
+    catch (const std::exception& error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+    init(scene.framebuffer.width, scene.framebuffer.height);
+
     bool running = true;
-    vector<Circle> circles = initializeCircles(numCircles, RESX, RESY);
-    
-    while (running) {
-        SDL_Event event;
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) running = false;
+    last_time = wallTime();
+
+    {
+        // El hilo de trabajo simula y dibuja el fractal del cuadro siguiente
+        FramePipeline pipeline(scene, 0.0f);
+
+        while (running) {
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT) running = false;
+#ifdef PARALELA_TRACE
+                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) showOverlay = !showOverlay;
+#endif
+            }
+            render(pipeline);
+        }
+    }
+    writeTrace(options);
+
+    // La tubería ya devolvió a la escena el último cuadro mostrado
+    int status = 0;
+    if (!options.saveSnapshot.empty()) {
+        try {
+            saveSnapshot(scene, options.saveSnapshot);
+        }
+        catch (const std::exception& error) {
+            cerr << error.what() << endl;
+            status = 1;
         }
-        render(circles);
     }
-    
-    delete window;
-    delete renderer;
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return status;
+#else
     return 0;
+#endif
 }
 
+#ifndef PARALELA_HEADLESS
 /**
- * Inicializa SDL y crea la ventana y el renderizador
+ * Inicializa SDL y crea la ventana, el renderizador y la textura de streaming
  */
 void init(const uint16_t RESX, const uint16_t RESY) {
     SDL_Init(SDL_INIT_VIDEO);
     window = SDL_CreateWindow("Paralela | 0.0 FPS", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, RESX, RESY, SDL_WINDOW_SHOWN);
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-}
-
-/**
- * Rota un vector 2D
- */
-vec2 rot(vec2 uv,float a){
-    return vec2(uv.x*cos(a)-uv.y*sin(a),uv.y*cos(a)+uv.x*sin(a));
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, RESX, RESY);
 }
 
 /**
  * Renderiza y actualiza la simulación
  */
-void render(vector<Circle>& circles) {
-    // Actualiza tiempos y FPS
-    current_time = clock();
-    delta_time = float(current_time - last_time) / CLOCKS_PER_SEC;
+void render(FramePipeline& pipeline) {
+    // Actualiza tiempos y FPS con el reloj de pared (clock() suma el tiempo de CPU de todos los hilos)
+    current_time = wallTime();
+    delta_time = current_time - last_time;
     last_time = current_time;
-    run_time += delta_time;
     window_time += delta_time;
-    
+
     if (window_time > update_time) {
         window_time -= update_time;
+#ifdef PARALELA_TRACE
+        const vec3 percentiles = framePercentiles(frameStats);
+        SDL_SetWindowTitle(window, ("Paralela | " + to_string(1.0 / delta_time) + " FPS | p50 " + to_string(percentiles.x) + " ms p95 " +
+            to_string(percentiles.y) + " ms p99 " + to_string(percentiles.z) + " ms").c_str());
+#else
         SDL_SetWindowTitle(window, ("Paralela | " + to_string(1.0 / delta_time) + " FPS").c_str());
+#endif
     }
-    
-    // Limpia la pantalla
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-    
-    // Dibuja el efecto fractal
-    const int maxIterations = 6;
-    const ivec2 start = ivec2((RESX / 2) - (RESX / 10), (RESY / 2) - (RESY / 10));
-    const ivec2 end   = ivec2((RESX / 2) + (RESX / 10), (RESY / 2) + (RESY / 10));
-    
-    #pragma omp parallel for collapse(2)
-    for (int x = start.x; x < end.x; x++) {
-        for (int y = start.y; y < end.y; y++) {
-            vec2 uv = (vec2(x,y) - (vec2(RESX, RESY) / 2.0f)) / float(RESX) * 10.0f;
-            uv *= sin(float(run_time)) * 0.5f + 1.5f;
-    
-            for(int i = 0; i < maxIterations; i++){
-                uv *= 2.1f;
-                uv = rot(uv, run_time);
-                uv = abs(uv);
-                uv -= 0.5f;
-            }
-    
-            #pragma omp critical
-            if (length(uv) <= 0.4f)
-                renderPoint(renderer, RESX, RESY, uvec2(x,y), ivec3(255));
-        }
-    }
-    
-    // Actualiza y dibuja las partículas
-    simulateStep(circles, vec2(RESX, RESY), delta_time, current_time);
-    for (const Circle& circle : circles) {
-        renderCircle(renderer, RESX, RESY, static_cast<uvec2>(circle.position), circle.display_radius, circle.color);
-    }
-    
+
+    // Compone el fractal y rasteriza las partículas del cuadro ya simulado
+    StageTimes times;
+    pipeline.renderFrame(times);
+
+#ifdef PARALELA_TRACE
+    recordFrameTime(frameStats, float(delta_time));
+    if (showOverlay) drawFrameOverlay(scene.framebuffer, frameStats);
+    TRACE_ZONE("present");
+#endif
+
+    // Sube el búfer completo a la textura una sola vez por cuadro
+    SDL_UpdateTexture(texture, nullptr, scene.framebuffer.pixels.data(), scene.framebuffer.pitch());
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
     SDL_RenderPresent(renderer);
 }
+#endif
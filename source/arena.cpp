@@ -0,0 +1,152 @@
+#include "arena.hpp"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+VirtualArena::VirtualArena(const size_t reserveBytes) {
+    reservedBytes = (reserveBytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+#ifdef _WIN32
+    // VirtualAlloc ya devuelve reservas alineadas a 64 KB
+    mappingBytes = reservedBytes;
+    mapping = VirtualAlloc(nullptr, mappingBytes, MEM_RESERVE, PAGE_READWRITE);
+    if (!mapping) throw std::bad_alloc();
+    base = static_cast<uint8_t*>(mapping);
+#else
+    // Reserva sin acceso y alinea el inicio a 2 MB para que el núcleo pueda usar páginas grandes
+    mappingBytes = reservedBytes + ARENA_ALIGNMENT;
+    mapping = mmap(nullptr, mappingBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::bad_alloc();
+    }
+    base = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(mapping) + ARENA_ALIGNMENT - 1) & ~uintptr_t(ARENA_ALIGNMENT - 1));
+#ifdef MADV_HUGEPAGE
+    madvise(base, reservedBytes, MADV_HUGEPAGE);
+#endif
+#endif
+}
+
+VirtualArena::~VirtualArena() {
+    release();
+}
+
+VirtualArena::VirtualArena(VirtualArena&& other) noexcept {
+    *this = std::move(other);
+}
+
+VirtualArena& VirtualArena::operator=(VirtualArena&& other) noexcept {
+    std::swap(base, other.base);
+    std::swap(mapping, other.mapping);
+    std::swap(mappingBytes, other.mappingBytes);
+    std::swap(reservedBytes, other.reservedBytes);
+    std::swap(committedBytes, other.committedBytes);
+#ifdef _WIN32
+    std::swap(viewBytes, other.viewBytes);
+#endif
+    return *this;
+}
+
+void VirtualArena::release() {
+    if (!mapping) return;
+#ifdef _WIN32
+    // Con una vista de archivo la reserva quedó partida en vista + resto reservado
+    if (viewBytes > 0) {
+        UnmapViewOfFile(base);
+        if (viewBytes < mappingBytes) VirtualFree(base + viewBytes, 0, MEM_RELEASE);
+        viewBytes = 0;
+    }
+    else {
+        VirtualFree(mapping, 0, MEM_RELEASE);
+    }
+#else
+    munmap(mapping, mappingBytes);
+#endif
+    mapping = nullptr;
+    base = nullptr;
+    mappingBytes = reservedBytes = committedBytes = 0;
+}
+
+void VirtualArena::commit(const size_t bytes) {
+    if (bytes <= committedBytes) return;
+    if (bytes > reservedBytes) throw std::bad_alloc();
+
+    // Confirma sólo el tramo nuevo; las páginas nuevas empiezan a cero
+    uint8_t* start = base + committedBytes;
+    const size_t length = bytes - committedBytes;
+#ifdef _WIN32
+    if (!VirtualAlloc(start, length, MEM_COMMIT, PAGE_READWRITE)) throw std::bad_alloc();
+#else
+    const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    const size_t alignedLength = (length + page - 1) / page * page;
+    if (mprotect(start, std::min(alignedLength, reservedBytes - committedBytes), PROT_READ | PROT_WRITE) != 0) throw std::bad_alloc();
+#endif
+    committedBytes = bytes;
+}
+
+void VirtualArena::mapFile(const MappableFile& file, const uint64_t offset, const size_t bytes) {
+    if (committedBytes != 0 || bytes == 0 || bytes > reservedBytes || offset + bytes > file.size()) {
+        throw runtime_error("Proyección de archivo inválida");
+    }
+
+#ifdef _WIN32
+    // Una vista no puede caer dentro de una reserva: se libera, se proyecta en la misma
+    // dirección y se vuelve a reservar el resto (base + bytes está alineado a 64 KB)
+    VirtualFree(mapping, 0, MEM_RELEASE);
+    void* view = MapViewOfFileEx(file.mapping, FILE_MAP_COPY, DWORD(offset >> 32), DWORD(offset & 0xFFFFFFFFu), bytes, base);
+    void* rest = bytes < mappingBytes ? VirtualAlloc(base + bytes, mappingBytes - bytes, MEM_RESERVE, PAGE_READWRITE) : base + bytes;
+    if (view != base || rest != base + bytes) {
+        if (view) UnmapViewOfFile(view);
+        if (rest && rest != base + bytes) VirtualFree(rest, 0, MEM_RELEASE);
+        mapping = nullptr;
+        base = nullptr;
+        mappingBytes = reservedBytes = 0;
+        throw runtime_error("No se pudo proyectar el archivo");
+    }
+    viewBytes = bytes;
+#else
+    // MAP_FIXED reemplaza las páginas reservadas por páginas del archivo con copia al escribir
+    void* view = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file.descriptor, off_t(offset));
+    if (view == MAP_FAILED) throw runtime_error("No se pudo proyectar el archivo");
+#endif
+    committedBytes = bytes;
+}
+
+MappableFile::MappableFile(const string& path) {
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        throw runtime_error("No se pudo abrir " + path);
+    }
+    bytes = uint64_t(fileSize.QuadPart);
+    mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw runtime_error("No se pudo proyectar " + path);
+    }
+#else
+    descriptor = open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (descriptor < 0 || fstat(descriptor, &info) != 0) {
+        if (descriptor >= 0) close(descriptor);
+        throw runtime_error("No se pudo abrir " + path);
+    }
+    bytes = uint64_t(info.st_size);
+#endif
+}
+
+MappableFile::~MappableFile() {
+#ifdef _WIN32
+    // Las vistas ya creadas mantienen viva la proyección
+    CloseHandle(mapping);
+    CloseHandle(file);
+#else
+    close(descriptor);
+#endif
+}
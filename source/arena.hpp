@@ -0,0 +1,78 @@
+/**
+ * arena.hpp
+ * Reserva de espacio de direcciones con confirmación por bloques
+ *
+ * Se reserva de una vez el máximo que puede llegar a ocupar un arreglo
+ * (alineado a páginas grandes de 2 MB) y la memoria se confirma por
+ * bloques a medida que crece, así que crecer nunca mueve ni copia datos.
+ * El inicio de una reserva también puede proyectar un archivo (copia
+ * al escribir), lo que permite cargar datos sin copiarlos.
+ */
+
+#pragma once
+#include "include.hpp"
+
+// Alineación de la reserva (página grande de 2 MB)
+constexpr size_t ARENA_ALIGNMENT = size_t(2) << 20;
+
+// Granularidad de los desplazamientos al proyectar un archivo (la de Windows, múltiplo de la página)
+constexpr uint64_t ARENA_MAP_GRANULARITY = 65536;
+
+// Archivo abierto sólo para proyectarlo en memoria
+class MappableFile {
+public:
+    explicit MappableFile(const string& path);   // Lanza runtime_error si no se puede abrir
+    ~MappableFile();
+
+    MappableFile(const MappableFile&) = delete;
+    MappableFile& operator=(const MappableFile&) = delete;
+
+    uint64_t size() const { return bytes; }
+
+private:
+    friend class VirtualArena;
+    uint64_t bytes = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
+
+// Región de memoria virtual reservada que se confirma bajo demanda
+class VirtualArena {
+public:
+    VirtualArena() = default;
+    explicit VirtualArena(const size_t reserveBytes);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+    VirtualArena(VirtualArena&& other) noexcept;
+    VirtualArena& operator=(VirtualArena&& other) noexcept;
+
+    // Asegura que los primeros bytes de la reserva estén confirmados (lanza bad_alloc si no hay memoria)
+    void commit(const size_t bytes);
+
+    // Proyecta bytes del archivo (desde offset) al inicio de una reserva aún sin confirmar;
+    // las escrituras son privadas y no modifican el archivo. bytes y offset deben ser múltiplos
+    // de ARENA_MAP_GRANULARITY. Lanza runtime_error si el sistema lo rechaza.
+    void mapFile(const MappableFile& file, const uint64_t offset, const size_t bytes);
+
+    uint8_t* data() const { return base; }
+    size_t reserved() const { return reservedBytes; }
+    size_t committed() const { return committedBytes; }
+
+private:
+    void release();
+
+    uint8_t* base = nullptr;        // Inicio alineado de la reserva
+    void* mapping = nullptr;        // Inicio real de la reserva (para liberarla)
+    size_t mappingBytes = 0;        // Tamaño real de la reserva
+    size_t reservedBytes = 0;       // Bytes utilizables a partir de base
+    size_t committedBytes = 0;      // Bytes confirmados a partir de base
+#ifdef _WIN32
+    size_t viewBytes = 0;           // Bytes del inicio ocupados por una vista de archivo
+#endif
+};
@@ -0,0 +1,429 @@
+#include "benchmark.hpp"
+#include "pipeline.hpp"
+#include "exporter.hpp"
+#include "snapshot.hpp"
+
+// Resultado de una combinación backend / hilos
+struct BenchmarkResult {
+    Backend backend;
+    int threads;
+    StageTimes times;        // Tiempo acumulado de cada etapa en los cuadros medidos
+    double wall;             // Tiempo de reloj de todos los cuadros medidos (con tubería las etapas se solapan)
+    uint64_t checksum;       // Hash del último cuadro, para comprobar que los backends coinciden
+    size_t particles;        // Partículas y resolución de la escena (con --load-snapshot, las de la instantánea)
+    int width;
+    int height;
+    uint64_t seed;           // Semilla del generador de la escena
+};
+
+static const char* backendName(const Backend backend) {
+    return backend == Backend::Sequential ? "sequential" : "openmp";
+}
+
+static const char* gravityName(const GravityMode mode) {
+    return mode == GravityMode::Off ? "off" : mode == GravityMode::BarnesHut ? "barnes-hut" : "brute-force";
+}
+
+const char* benchmarkUsage() {
+    return
+        "Uso: Paralela --headless [opciones]\n"
+        "  --frames N           Cuadros medidos (300)\n"
+        "  --warmup N           Cuadros previos sin medir (10)\n"
+        "  --particles N        Número de partículas (2048)\n"
+        "  --resolution WxH     Resolución del búfer (1000x600)\n"
+        "  --seed N             Semilla de las partículas (1)\n"
+        "  --dt S               Paso de tiempo fijo en segundos (0.016667)\n"
+        "  --backend B          sequential, openmp o all (all)\n"
+        "  --threads A,B,...    Hilos a probar con OpenMP (1,2,4,... máximo)\n"
+        "  --circles M          outline, filled o antialiased (outline)\n"
+        "  --shading S          exact o lut (exact)\n"
+        "  --gravity G          off, barnes-hut o brute-force (off)\n"
+        "  --theta T            Ángulo de apertura de Barnes-Hut (0.5)\n"
+        "  --fractal F          full o center (full)\n"
+        "  --pipeline           Simula el cuadro siguiente mientras se rasteriza el actual\n"
+        "  --format F           csv o json (csv)\n"
+        "  --output FILE        Archivo de salida (salida estándar)\n"
+        "  --export PATH        Exporta cada cuadro en lugar de medir (sin calentamiento)\n"
+        "  --export-format F    raw, ppm o y4m (y4m)\n"
+        "  --load-snapshot FILE Parte del estado guardado (sustituye a --particles, --seed y --resolution)\n"
+        "  --save-snapshot FILE Guarda el estado final de la primera ejecución (o al cerrar la ventana)\n"
+        "  --trace FILE         Traza de zonas en formato Chrome (requiere PARALELA_TRACE)\n"
+        "  --check C            Comprueba la simulación en lugar de medir: collisions, gravity, snapshot, particles o all\n"
+        "Sin --headless (ventana) se aceptan --particles, --resolution, --seed, --circles, --shading,\n"
+        "--gravity, --theta, --fractal, --load-snapshot, --save-snapshot y --trace.\n";
+}
+
+// Convierte un argumento a entero positivo o lanza una excepción
+static int parsePositive(const string& name, const string& value) {
+    size_t used = 0;
+    int result = 0;
+    try {
+        result = stoi(value, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != value.size() || result <= 0) {
+        throw runtime_error("Valor inválido para " + name + ": " + value);
+    }
+    return result;
+}
+
+// Convierte un argumento a un número real finito o lanza una excepción
+static float parseReal(const string& name, const string& value) {
+    size_t used = 0;
+    float result = 0.0f;
+    try {
+        result = stof(value, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != value.size() || used == 0 || !std::isfinite(result)) {
+        throw runtime_error("Valor inválido para " + name + ": " + value);
+    }
+    return result;
+}
+
+// Convierte un argumento a un conteo de 64 bits o lanza una excepción
+static uint64_t parseCount(const string& name, const string& value) {
+    size_t used = 0;
+    uint64_t result = 0;
+    try {
+        result = stoull(value, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != value.size() || used == 0 || value[0] == '-') {
+        throw runtime_error("Valor inválido para " + name + ": " + value);
+    }
+    return result;
+}
+
+bool parseBenchmarkOptions(int argc, char* argv[], BenchmarkOptions& options) {
+#ifdef PARALELA_HEADLESS
+    bool headless = true;
+#else
+    bool headless = false;
+#endif
+
+    // Opciones que la ventana no usa (la ventana sigue el reloj de pared y siempre usa la tubería)
+    static const char* const HEADLESS_ONLY[] = {
+        "--frames", "--warmup", "--dt", "--backend", "--threads", "--pipeline", "--format", "--output",
+        "--export", "--export-format", "--check"
+    };
+    string headlessOnly;
+
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if (headlessOnly.empty() && std::find(std::begin(HEADLESS_ONLY), std::end(HEADLESS_ONLY), arg) != std::end(HEADLESS_ONLY)) {
+            headlessOnly = arg;
+        }
+        if (arg == "--headless") {
+            headless = true;
+            continue;
+        }
+        if (arg == "--pipeline") {
+            options.pipeline = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw runtime_error("Opción desconocida o sin valor: " + arg);
+        }
+
+        const string value = argv[++i];
+        if (arg == "--frames") {
+            options.frames = parsePositive(arg, value);
+        }
+        else if (arg == "--warmup") {
+            options.warmup = value == "0" ? 0 : parsePositive(arg, value);
+        }
+        else if (arg == "--particles") {
+            options.particles = parseCount(arg, value);
+            if (options.particles == 0 || options.particles > PARTICLE_MAX_CAPACITY) {
+                throw runtime_error("--particles debe estar entre 1 y " + to_string(PARTICLE_MAX_CAPACITY));
+            }
+        }
+        else if (arg == "--resolution") {
+            const size_t split = value.find('x');
+            if (split == string::npos) throw runtime_error("Resolución inválida: " + value);
+            options.width = parsePositive(arg, value.substr(0, split));
+            options.height = parsePositive(arg, value.substr(split + 1));
+            if (options.width > 65535 || options.height > 65535) throw runtime_error("Resolución inválida: " + value);
+        }
+        else if (arg == "--seed") {
+            options.seed = parseCount(arg, value);
+        }
+        else if (arg == "--dt") {
+            options.deltaTime = parseReal(arg, value);
+            if (options.deltaTime <= 0.0f) throw runtime_error("--dt debe ser mayor que 0: " + value);
+        }
+        else if (arg == "--backend") {
+            if (value == "sequential") options.backends = { Backend::Sequential };
+            else if (value == "openmp") options.backends = { Backend::OpenMP };
+            else if (value == "all") options.backends = { Backend::Sequential, Backend::OpenMP };
+            else throw runtime_error("Backend desconocido: " + value);
+        }
+        else if (arg == "--threads") {
+            options.threads.clear();
+            stringstream list(value);
+            string item;
+            while (getline(list, item, ',')) {
+                options.threads.push_back(parsePositive(arg, item));
+            }
+        }
+        else if (arg == "--circles") {
+            if (value == "outline") options.circleMode = CircleMode::Outline;
+            else if (value == "filled") options.circleMode = CircleMode::Filled;
+            else if (value == "antialiased") options.circleMode = CircleMode::Antialiased;
+            else throw runtime_error("Modo de círculos desconocido: " + value);
+        }
+        else if (arg == "--shading") {
+            if (value == "exact") options.shadeMode = ShadeMode::Exact;
+            else if (value == "lut") options.shadeMode = ShadeMode::Lut;
+            else throw runtime_error("Modo de color desconocido: " + value);
+        }
+        else if (arg == "--gravity") {
+            if (value == "off") options.gravity.mode = GravityMode::Off;
+            else if (value == "barnes-hut") options.gravity.mode = GravityMode::BarnesHut;
+            else if (value == "brute-force") options.gravity.mode = GravityMode::BruteForce;
+            else throw runtime_error("Modo de gravedad desconocido: " + value);
+        }
+        else if (arg == "--theta") {
+            options.gravity.theta = parseReal(arg, value);
+            if (options.gravity.theta < 0.0f) throw runtime_error("Valor inválido para --theta: " + value);
+        }
+        else if (arg == "--fractal") {
+            if (value != "full" && value != "center") throw runtime_error("Modo de fractal desconocido: " + value);
+            options.fullScreenFractal = value == "full";
+        }
+        else if (arg == "--format") {
+            if (value != "csv" && value != "json") throw runtime_error("Formato desconocido: " + value);
+            options.format = value;
+        }
+        else if (arg == "--output") {
+            options.output = value;
+        }
+        else if (arg == "--load-snapshot") {
+            options.loadSnapshot = value;
+        }
+        else if (arg == "--save-snapshot") {
+            options.saveSnapshot = value;
+        }
+        else if (arg == "--trace") {
+#ifndef PARALELA_TRACE
+            throw runtime_error("--trace requiere compilar con PARALELA_TRACE");
+#endif
+            options.tracePath = value;
+        }
+        else if (arg == "--check") {
+            if (value != "collisions" && value != "gravity" && value != "snapshot" && value != "particles" && value != "all") throw runtime_error("Comprobación desconocida: " + value);
+            options.check = value;
+        }
+        else if (arg == "--export") {
+            options.exportPath = value;
+        }
+        else if (arg == "--export-format") {
+            if (value == "raw") options.exportFormat = ExportFormat::Raw;
+            else if (value == "ppm") options.exportFormat = ExportFormat::Ppm;
+            else if (value == "y4m") options.exportFormat = ExportFormat::Y4m;
+            else throw runtime_error("Formato de exportación desconocido: " + value);
+        }
+        else {
+            throw runtime_error("Opción desconocida: " + arg);
+        }
+    }
+
+    if (!headless && !headlessOnly.empty()) {
+        throw runtime_error(headlessOnly + " sólo se usa con --headless");
+    }
+    return headless;
+}
+
+// Hash FNV-1a de los píxeles del búfer
+static uint64_t hashPixels(const vector<uint32_t>& pixels) {
+    uint64_t hash = 1469598103934665603ull;
+    for (const uint32_t pixel : pixels) {
+        hash = (hash ^ pixel) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void setupScene(Scene& scene, const BenchmarkOptions& options) {
+    scene.fractal.fullScreen = options.fullScreenFractal;
+    scene.circleMode = options.circleMode;
+    scene.simulation.shading.mode = options.shadeMode;
+    scene.simulation.gravity = options.gravity;
+    if (!options.loadSnapshot.empty()) loadSnapshot(scene, options.loadSnapshot);
+    else initializeScene(scene, size_t(options.particles), uint16_t(options.width), uint16_t(options.height), options.seed);
+}
+
+// Ejecuta la escena con un backend y un número de hilos dados
+static BenchmarkResult runConfiguration(const BenchmarkOptions& options, const Backend backend, const int threads, const bool save) {
+    omp_set_num_threads(threads);
+
+    Scene scene;
+    setupScene(scene, options);
+
+    // Sin ventana, la etapa de presentación es la copia que haría SDL_UpdateTexture
+    vector<uint32_t> staging(scene.framebuffer.pixels.size());
+    StageTimes times;
+    double start = wallTime();
+
+    std::optional<FramePipeline> pipeline;
+    if (options.pipeline) pipeline.emplace(scene, options.deltaTime);
+
+    for (int frame = 0; frame < options.warmup + options.frames; ++frame) {
+        if (frame == options.warmup) {
+            times = StageTimes();
+            start = wallTime();
+        }
+
+        if (pipeline) pipeline->renderFrame(times);
+        else renderScene(scene, options.deltaTime, times);
+
+        TRACE_ZONE("present");
+        const double presentStart = wallTime();
+        std::memcpy(staging.data(), scene.framebuffer.pixels.data(), staging.size() * sizeof(uint32_t));
+        times.present += wallTime() - presentStart;
+    }
+
+    const double wall = wallTime() - start;
+
+    // La tubería devuelve a la escena el último estado simulado al destruirse
+    pipeline.reset();
+    if (save) saveSnapshot(scene, options.saveSnapshot);
+
+    return { backend, threads, times, wall, hashPixels(staging), scene.particles.count, int(scene.framebuffer.width), int(scene.framebuffer.height), scene.random.seed };
+}
+
+// Escribe los resultados en CSV
+static void writeCsv(ostream& out, const BenchmarkOptions& options, const vector<BenchmarkResult>& results, const double baseline) {
+    out << "backend,threads,pipeline,frames,particles,width,height,simulate_ms,fractal_ms,raster_ms,present_ms,frame_ms,fps,speedup,checksum\n";
+    for (const BenchmarkResult& result : results) {
+        const double scale = 1000.0 / options.frames;
+        out << backendName(result.backend) << ',' << result.threads << ',' << int(options.pipeline) << ',' << options.frames << ',' << result.particles << ','
+            << result.width << ',' << result.height << ','
+            << fixed << setprecision(4)
+            << result.times.simulate * scale << ',' << result.times.fractal * scale << ','
+            << result.times.raster * scale << ',' << result.times.present * scale << ','
+            << result.wall * scale << ',' << options.frames / result.wall << ','
+            << baseline / result.wall << ','
+            << hex << setw(16) << setfill('0') << result.checksum << dec << setfill(' ') << '\n';
+    }
+}
+
+// Escribe los resultados en JSON (todas las ejecuciones parten de la misma escena)
+static void writeJson(ostream& out, const BenchmarkOptions& options, const vector<BenchmarkResult>& results, const double baseline) {
+    out << "{\n"
+        << "  \"frames\": " << options.frames << ",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"particles\": " << results.front().particles << ",\n"
+        << "  \"width\": " << results.front().width << ",\n"
+        << "  \"height\": " << results.front().height << ",\n"
+        << "  \"seed\": " << results.front().seed << ",\n"
+        << "  \"pipeline\": " << (options.pipeline ? "true" : "false") << ",\n"
+        << "  \"gravity\": \"" << gravityName(options.gravity.mode) << "\",\n"
+        << "  \"theta\": " << options.gravity.theta << ",\n"
+        << "  \"kernel\": \"" << particleKernelName() << "\",\n"
+        << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        const double scale = 1000.0 / options.frames;
+        out << fixed << setprecision(4)
+            << "    { \"backend\": \"" << backendName(result.backend) << "\", \"threads\": " << result.threads
+            << ", \"simulate_ms\": " << result.times.simulate * scale
+            << ", \"fractal_ms\": " << result.times.fractal * scale
+            << ", \"raster_ms\": " << result.times.raster * scale
+            << ", \"present_ms\": " << result.times.present * scale
+            << ", \"frame_ms\": " << result.wall * scale
+            << ", \"fps\": " << options.frames / result.wall
+            << ", \"speedup\": " << baseline / result.wall
+            << ", \"checksum\": \"" << hex << setw(16) << setfill('0') << result.checksum << dec << setfill(' ') << "\" }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n}\n";
+}
+
+int runBenchmark(const BenchmarkOptions& options) {
+    const int defaultThreads = omp_get_max_threads();
+
+    // Curva de escalado por defecto: potencias de dos hasta el número de procesadores
+    vector<int> threadCounts = options.threads;
+    if (threadCounts.empty()) {
+        const int maxThreads = omp_get_num_procs();
+        for (int t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(maxThreads);
+    }
+
+    vector<BenchmarkResult> results;
+    for (const Backend backend : options.backends) {
+        if (backend == Backend::Sequential) {
+            results.push_back(runConfiguration(options, backend, 1, !options.saveSnapshot.empty() && results.empty()));
+            continue;
+        }
+        for (const int threads : threadCounts) {
+            results.push_back(runConfiguration(options, backend, threads, !options.saveSnapshot.empty() && results.empty()));
+        }
+    }
+    omp_set_num_threads(defaultThreads);
+
+    // La aceleración se mide respecto al secuencial, o a la primera ejecución si no lo hay
+    double baseline = results.front().wall;
+    for (const BenchmarkResult& result : results) {
+        if (result.backend == Backend::Sequential) baseline = result.wall;
+    }
+
+    ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            cerr << "No se pudo abrir " << options.output << endl;
+            return 1;
+        }
+    }
+    ostream& out = options.output.empty() ? cout : file;
+
+    if (options.format == "json") writeJson(out, options, results, baseline);
+    else writeCsv(out, options, results, baseline);
+    return 0;
+}
+
+int runExport(const BenchmarkOptions& options) {
+    if (!options.threads.empty()) omp_set_num_threads(options.threads.front());
+
+    Scene scene;
+    setupScene(scene, options);
+
+    try {
+        // Mismo paso y semilla que el modo de medición: el cuadro N exportado es el cuadro N medido
+        FrameExporter exporter(options.exportPath, options.exportFormat, scene.framebuffer.width, scene.framebuffer.height, options.deltaTime);
+        std::optional<FramePipeline> pipeline;
+        if (options.pipeline) pipeline.emplace(scene, options.deltaTime);
+
+        StageTimes times;
+        const double start = wallTime();
+        for (int frame = 0; frame < options.frames; ++frame) {
+            if (pipeline) pipeline->renderFrame(times);
+            else renderScene(scene, options.deltaTime, times);
+            exporter.submit(scene.framebuffer);
+        }
+        const double rendered = wallTime() - start;
+        exporter.finish();
+        const double total = wallTime() - start;
+
+        pipeline.reset();
+        if (!options.saveSnapshot.empty()) saveSnapshot(scene, options.saveSnapshot);
+
+        cerr << "Exportados " << exporter.framesWritten() << " cuadros (" << fixed << setprecision(1) << exporter.bytesWritten() / 1048576.0 << " MB) en "
+             << setprecision(3) << total << " s; render " << options.frames / rendered << " FPS, espera al escritor " << exporter.stallTime() << " s\n";
+    }
+    catch (const std::exception& error) {
+        cerr << error.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * benchmark.hpp
+ * Modo sin ventana para medir el rendimiento
+ *
+ * Ejecuta N cuadros con paso de tiempo y semilla fijos, mide el tiempo
+ * de reloj de cada etapa y compara el backend secuencial con OpenMP
+ * para distintos números de hilos. Los resultados salen en CSV o JSON.
+ */
+
+#pragma once
+#include "include.hpp"
+#include "rasterizer.hpp"
+#include "shading.hpp"
+#include "gravity.hpp"
+#include "exporter.hpp"
+
+struct Scene;
+
+// Backend de ejecución elegido en tiempo de ejecución
+enum class Backend {
+    Sequential,   // Un solo hilo
+    OpenMP        // Equipo de hilos OpenMP
+};
+
+// Parámetros del modo sin ventana
+struct BenchmarkOptions {
+    int frames = 300;                              // Cuadros medidos
+    int warmup = 10;                               // Cuadros previos sin medir
+    uint64_t particles = 2048;                     // Número de partículas
+    int width = 1000;                              // Resolución horizontal
+    int height = 600;                              // Resolución vertical
+    uint64_t seed = 1;                             // Semilla de las partículas
+    float deltaTime = 1.0f / 60.0f;                // Paso de tiempo fijo
+    vector<Backend> backends = { Backend::Sequential, Backend::OpenMP };
+    vector<int> threads;                           // Hilos a probar con OpenMP (vacío: 1, 2, 4, ... máximo)
+    CircleMode circleMode = CircleMode::Outline;   // Forma de dibujar las partículas
+    ShadeMode shadeMode = ShadeMode::Exact;        // Color exacto o por tabla
+    GravitySettings gravity;                       // Gravedad entre partículas (apagada por defecto)
+    bool fullScreenFractal = true;                 // Fractal en toda la ventana
+    bool pipeline = false;                         // Simula el cuadro siguiente mientras se rasteriza el actual
+    string format = "csv";                         // "csv" o "json"
+    string output;                                 // Archivo de salida (vacío: salida estándar)
+    string exportPath;                             // Exporta los cuadros aquí en lugar de medir (vacío: no exporta)
+    ExportFormat exportFormat = ExportFormat::Y4m; // Formato de los cuadros exportados
+    string loadSnapshot;                           // Instantánea de partida (vacío: partículas nuevas)
+    string saveSnapshot;                           // Instantánea del estado final (vacío: no guarda)
+    string tracePath;                              // Traza de zonas al terminar (vacío: no escribe)
+    string check;                                  // Comprobación de corrección en lugar de medir (vacío: mide)
+};
+
+// Lee las opciones de la línea de comandos; devuelve true si se pidió el modo sin ventana
+// (lanza runtime_error con valores inválidos o con opciones sólo de --headless en la ventana)
+bool parseBenchmarkOptions(int argc, char* argv[], BenchmarkOptions& options);
+
+// Texto de ayuda de las opciones
+const char* benchmarkUsage();
+
+// Configura la escena con las opciones de la línea de comandos (partículas nuevas o instantánea)
+void setupScene(Scene& scene, const BenchmarkOptions& options);
+
+// Ejecuta todas las combinaciones de backend e hilos y escribe los resultados
+int runBenchmark(const BenchmarkOptions& options);
+
+// Renderiza options.frames cuadros con paso y semilla fijos y los escribe con FrameExporter
+int runExport(const BenchmarkOptions& options);
@@ -0,0 +1,264 @@
+#include "checks.hpp"
+#include "scene.hpp"
+#include "snapshot.hpp"
+#include "pipeline.hpp"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Escribe el resultado de una comprobación y devuelve si pasó
+static bool report(const string& name, const double error, const double tolerance) {
+    const bool passed = error <= tolerance;
+    cout << name << ": " << scientific << setprecision(3) << error << " (tolerancia " << tolerance << ") "
+         << (passed ? "OK" : "FALLA") << defaultfloat << '\n';
+    return passed;
+}
+
+// Energía cinética, momento total y suma de |momento| de las partículas (en doble precisión)
+static void measureMotion(const ParticleSystem& particles, double& energy, dvec2& momentum, double& momentumScale) {
+    energy = 0.0;
+    momentum = dvec2(0.0);
+    momentumScale = 0.0;
+    for (size_t i = 0; i < particles.count; ++i) {
+        const dvec2 velocity = dvec2(particles.velocityX[i], particles.velocityY[i]);
+        energy += 0.5 * particles.mass[i] * dot(velocity, velocity);
+        momentum += double(particles.mass[i]) * velocity;
+        momentumScale += particles.mass[i] * length(velocity);
+    }
+}
+
+// Las colisiones entre partículas son elásticas: conservan momento en cada paso y energía
+// a lo largo de CHECK_FRAMES cuadros (los rebotes en los bordes tampoco cambian la energía)
+static bool checkCollisions(const BenchmarkOptions& options) {
+    Scene scene;
+    initializeScene(scene, size_t(options.particles), uint16_t(options.width), uint16_t(options.height), options.seed);
+
+    double energyBefore, scaleBefore, energyAfter, scaleAfter;
+    dvec2 momentumBefore, momentumAfter;
+    measureMotion(scene.particles, energyBefore, momentumBefore, scaleBefore);
+
+    // Un paso de colisiones aislado, sin bordes que cambien el momento
+    buildSpatialGrid(scene.simulation.grid, scene.particles, scene.bounds);
+    resolveCircleCollisions(scene.particles, scene.simulation.grid);
+    measureMotion(scene.particles, energyAfter, momentumAfter, scaleAfter);
+    bool passed = report("colisiones.momento", length(momentumAfter - momentumBefore) / scaleBefore, 1e-5);
+
+    // Simulación completa sin gravedad
+    for (int frame = 0; frame < CHECK_FRAMES; ++frame) {
+        simulateParticles(scene.particles, scene.simulation, scene.bounds, options.deltaTime, float(frame) * options.deltaTime);
+    }
+    measureMotion(scene.particles, energyAfter, momentumAfter, scaleAfter);
+    passed &= report("colisiones.energia", abs(energyAfter - energyBefore) / energyBefore, 1e-3);
+    return passed;
+}
+
+// Error RMS relativo de Barnes-Hut frente a la suma directa con un ángulo de apertura dado
+static double barnesHutError(const ParticleSystem& particles, QuadTree& tree, const float theta) {
+    GravitySettings settings;
+    settings.theta = theta;
+
+    vector<vec2> reference;
+    computeBruteForce(reference, particles, settings);
+    buildQuadTree(tree, particles);
+    computeBarnesHut(tree, particles, settings);
+
+    double error = 0.0, norm = 0.0;
+    for (size_t i = 0; i < particles.count; ++i) {
+        const dvec2 difference = dvec2(tree.acceleration[i]) - dvec2(reference[i]);
+        error += dot(difference, difference);
+        norm += dot(dvec2(reference[i]), dvec2(reference[i]));
+    }
+    return sqrt(error / norm);
+}
+
+// Barnes-Hut coincide con la referencia O(n²): casi exacto con theta = 0 y dentro de una
+// tolerancia con el ángulo por defecto, antes y después de que la gravedad agrupe las partículas
+static bool checkGravity(const BenchmarkOptions& options) {
+    Scene scene;
+    initializeScene(scene, size_t(options.particles), uint16_t(options.width), uint16_t(options.height), options.seed);
+    QuadTree& tree = scene.simulation.tree;
+
+    bool passed = report("gravedad.theta0", barnesHutError(scene.particles, tree, 0.0f), 1e-4);
+    passed &= report("gravedad.theta05", barnesHutError(scene.particles, tree, 0.5f), 3e-2);
+
+    scene.simulation.gravity.mode = GravityMode::BarnesHut;
+    for (int frame = 0; frame < CHECK_FRAMES / 5; ++frame) {
+        simulateParticles(scene.particles, scene.simulation, scene.bounds, options.deltaTime, float(frame) * options.deltaTime);
+    }
+    passed &= report("gravedad.agrupada.theta0", barnesHutError(scene.particles, tree, 0.0f), 1e-4);
+    passed &= report("gravedad.agrupada.theta05", barnesHutError(scene.particles, tree, 0.5f), 3e-2);
+    return passed;
+}
+
+// Arreglos de un sistema de partículas en el orden de sus miembros
+static array<float*, PARTICLE_FIELDS> particleFields(const ParticleSystem& particles) {
+    return { particles.positionX, particles.positionY, particles.velocityX, particles.velocityY,
+        particles.displayRadius, particles.radius, particles.mass, reinterpret_cast<float*>(particles.color) };
+}
+
+// Crear partículas más allá de un bloque no mueve los arreglos ni toca las existentes, y da lo
+// mismo que crearlas de una vez; eliminarlas conserva el resto y deja a cero el relleno
+static bool checkParticles(const BenchmarkOptions& options) {
+    const vec2 bounds = vec2(float(options.width), float(options.height));
+    const size_t before = PARTICLE_CHUNK - 100;
+    const size_t added = 300;
+
+    ParticleSystem particles;
+    CounterRng random(options.seed);
+    spawnParticles(particles, before, bounds, random);
+    const array<float*, PARTICLE_FIELDS> fields = particleFields(particles);
+    const size_t capacity = particles.capacity;
+
+    // Copia de las partículas existentes para comprobar que sobreviven
+    vector<float> saved(PARTICLE_FIELDS * before);
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        std::memcpy(&saved[f * before], fields[f], before * sizeof(float));
+    }
+
+    spawnParticles(particles, added, bounds, random);
+    size_t moved = 0, changed = 0;
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        moved += particleFields(particles)[f] != fields[f] ? 1 : 0;
+        changed += std::memcmp(&saved[f * before], fields[f], before * sizeof(float)) != 0 ? 1 : 0;
+    }
+    bool passed = report("particulas.crecer", particles.capacity > capacity ? 0.0 : 1.0, 0.0);
+    passed &= report("particulas.direcciones", double(moved), 0.0);
+    passed &= report("particulas.conservadas", double(changed), 0.0);
+
+    // El generador por contador no depende de en cuántas tandas se crean
+    ParticleSystem once;
+    CounterRng onceRandom(options.seed);
+    spawnParticles(once, before + added, bounds, onceRandom);
+    size_t different = 0;
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        different += std::memcmp(particleFields(once)[f], fields[f], (before + added) * sizeof(float)) != 0 ? 1 : 0;
+    }
+    passed &= report("particulas.deterministas", double(different), 0.0);
+
+    // El color hace de identificador para seguir a cada partícula tras los intercambios
+    const size_t total = particles.count;
+    for (size_t i = 0; i < total; ++i) particles.color[i] = uint32_t(i);
+    vector<uint32_t> removed;
+    for (size_t i = 0; i < total; i += 7) removed.push_back(uint32_t(i));
+    removed.push_back(0);
+    removed.push_back(uint32_t(total - 1));
+    removed.push_back(uint32_t(total + 5));
+    const vector<uint32_t> request = removed;
+    despawnParticles(particles, removed);
+
+    vector<bool> expected(total, true);
+    size_t expectedCount = 0;
+    for (const uint32_t index : removed) {
+        if (index < total) expected[index] = false;
+    }
+    for (size_t i = 0; i < total; ++i) expectedCount += expected[i] ? 1 : 0;
+
+    // Cada superviviente aparece una vez y con sus valores originales
+    size_t errors = particles.count == expectedCount ? 0 : 1;
+    vector<bool> seen(total, false);
+    for (size_t i = 0; i < particles.count && errors == 0; ++i) {
+        const uint32_t id = particles.color[i];
+        if (id >= total || !expected[id] || seen[id] || particles.positionX[i] != once.positionX[id] || particles.radius[i] != once.radius[id]) {
+            errors++;
+        }
+        else {
+            seen[id] = true;
+        }
+    }
+    passed &= report("particulas.eliminar", double(errors), 0.0);
+    passed &= report("particulas.indices", removed == request ? 0.0 : 1.0, 0.0);
+
+    // Todo lo que queda tras count, incluido el relleno que recorren los kernels, está a cero
+    size_t dirty = 0;
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        const float* field = particleFields(particles)[f];
+        for (size_t i = particles.count; i < particles.capacity; ++i) dirty += field[i] != 0.0f ? 1 : 0;
+    }
+    passed &= report("particulas.relleno", double(dirty), 0.0);
+    return passed;
+}
+
+// Compara byte a byte las partículas, el tiempo y el generador de dos escenas
+static bool sameState(const Scene& a, const Scene& b) {
+    if (a.particles.count != b.particles.count || a.time != b.time || a.frame != b.frame ||
+        a.random.seed != b.random.seed || a.random.counter != b.random.counter) {
+        return false;
+    }
+    const float* fieldsA[PARTICLE_FIELDS] = { a.particles.positionX, a.particles.positionY, a.particles.velocityX, a.particles.velocityY,
+        a.particles.displayRadius, a.particles.radius, a.particles.mass, reinterpret_cast<const float*>(a.particles.color) };
+    const float* fieldsB[PARTICLE_FIELDS] = { b.particles.positionX, b.particles.positionY, b.particles.velocityX, b.particles.velocityY,
+        b.particles.displayRadius, b.particles.radius, b.particles.mass, reinterpret_cast<const float*>(b.particles.color) };
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        if (std::memcmp(fieldsA[f], fieldsB[f], a.particles.count * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+// Avanza la escena un número de cuadros con el paso fijo de las opciones (con tubería si se pidió)
+static void advanceScene(Scene& scene, const BenchmarkOptions& options, const int frames) {
+    StageTimes times;
+    std::optional<FramePipeline> pipeline;
+    if (options.pipeline) pipeline.emplace(scene, options.deltaTime);
+    for (int frame = 0; frame < frames; ++frame) {
+        if (pipeline) pipeline->renderFrame(times);
+        else renderScene(scene, options.deltaTime, times);
+    }
+}
+
+// Guardar a mitad y continuar desde la instantánea da el mismo estado que una ejecución seguida sin
+// tubería (también si las dos mitades usan la tubería), y guardar sobre la instantánea de la que se
+// cargó la escena no pierde datos
+static bool checkSnapshot(const BenchmarkOptions& options) {
+    // Un archivo por proceso para que ctest -j pueda ejecutar las variantes a la vez
+#ifdef _WIN32
+    const unsigned long process = GetCurrentProcessId();
+#else
+    const long process = long(getpid());
+#endif
+    const string name = "paralela-check-" + std::to_string(process) + ".snap";
+    const string path = (std::filesystem::temp_directory_path() / name).string();
+    const int half = CHECK_FRAMES / 12;
+    BenchmarkOptions resume = options;
+    resume.loadSnapshot = path;
+
+    BenchmarkOptions serial = options;
+    serial.pipeline = false;
+
+    Scene straight;
+    setupScene(straight, serial);
+    advanceScene(straight, serial, 2 * half);
+
+    Scene first;
+    setupScene(first, options);
+    advanceScene(first, options, half);
+    saveSnapshot(first, path);
+
+    Scene resumed;
+    setupScene(resumed, resume);
+    advanceScene(resumed, options, half);
+    bool passed = report("instantanea.reanudar", sameState(straight, resumed) ? 0.0 : 1.0, 0.0);
+
+    // resumed sigue proyectando path mientras se reemplaza; se compara con straight, que no
+    // depende del archivo (los campos que no se escriben, como radius, se leen de la proyección)
+    saveSnapshot(resumed, path);
+    Scene reloaded;
+    setupScene(reloaded, resume);
+    passed &= report("instantanea.sobrescribir", sameState(straight, reloaded) ? 0.0 : 1.0, 0.0);
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    return passed;
+}
+
+int runChecks(const BenchmarkOptions& options) {
+    if (!options.threads.empty()) omp_set_num_threads(options.threads.front());
+
+    const bool all = options.check == "all";
+    bool passed = true;
+    if (all || options.check == "collisions") passed &= checkCollisions(options);
+    if (all || options.check == "gravity") passed &= checkGravity(options);
+    if (all || options.check == "snapshot") passed &= checkSnapshot(options);
+    if (all || options.check == "particles") passed &= checkParticles(options);
+    return passed ? 0 : 1;
+}
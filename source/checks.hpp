@@ -0,0 +1,17 @@
+/**
+ * checks.hpp
+ * Comprobaciones de corrección de la simulación
+ *
+ * Cada comprobación ejecuta un caso con semilla fija, mide un error y lo
+ * compara con una tolerancia. Se lanzan con --headless --check NOMBRE y
+ * CTest las ejecuta todas; el proceso termina con 1 si alguna falla.
+ */
+
+#pragma once
+#include "benchmark.hpp"
+
+// Cuadros que simula la comprobación de conservación
+constexpr int CHECK_FRAMES = 600;
+
+// Ejecuta la comprobación options.check ("all" para todas); devuelve 0 si todas pasan
+int runChecks(const BenchmarkOptions& options);
@@ -0,0 +1,171 @@
+#include "exporter.hpp"
+#include "scene.hpp"
+#include "trace.hpp"
+
+FrameExporter::FrameExporter(const string& path, const ExportFormat format, const uint16_t width, const uint16_t height, const float deltaTime)
+    : path(path), format(format), width(width), height(height) {
+    const size_t pixels = size_t(width) * height;
+    for (vector<uint32_t>& slot : slots) {
+        slot.resize(pixels);
+    }
+    // RGBA usa 4 bytes por píxel; PPM y Y4M 4:4:4 usan 3
+    encoded.resize(pixels * (format == ExportFormat::Raw ? 4 : 3));
+
+    if (format != ExportFormat::Ppm) {
+        stream.open(path, ios::binary);
+        if (!stream) throw runtime_error("No se pudo abrir " + path);
+    }
+
+    if (format == ExportFormat::Y4m) {
+        // Tasa de cuadros como fracción: entera si el paso lo permite, si no en milésimas
+        const double rate = deltaTime > 0.0f ? 1.0 / deltaTime : 60.0;
+        const bool integral = std::abs(rate - std::round(rate)) < 1e-3;
+        const uint64_t numerator = uint64_t(std::round(integral ? rate : rate * 1000.0));
+        const string header = "YUV4MPEG2 W" + to_string(width) + " H" + to_string(height) + " F" + to_string(numerator) + ":" + (integral ? "1" : "1000") + " Ip A1:1 C444\n";
+        stream.write(header.data(), streamsize(header.size()));
+        written += header.size();
+    }
+
+    writer = std::thread(&FrameExporter::write, this);
+}
+
+FrameExporter::~FrameExporter() {
+    try {
+        finish();
+    }
+    catch (const std::exception&) {
+        // El error ya se informó si alguien llamó a finish(); aquí sólo se cierra
+    }
+}
+
+void FrameExporter::submit(const Framebuffer& framebuffer) {
+    if (failed.load(std::memory_order_acquire)) throw runtime_error("Exportación fallida: " + error);
+
+    // El búfer de este cuadro queda libre cuando el escritor terminó el cuadro frame - EXPORT_RING_SLOTS
+    const uint64_t frame = produced.load(std::memory_order_relaxed);
+    uint64_t done = consumed.load(std::memory_order_acquire);
+    if (done + EXPORT_RING_SLOTS < frame + 1) {
+        TRACE_WAIT("export.wait_writer");
+        const double waitStart = wallTime();
+        while (done + EXPORT_RING_SLOTS < frame + 1) {
+            consumed.wait(done, std::memory_order_acquire);
+            done = consumed.load(std::memory_order_acquire);
+        }
+        stall += wallTime() - waitStart;
+    }
+
+    vector<uint32_t>& slot = slots[frame % EXPORT_RING_SLOTS];
+    std::memcpy(slot.data(), framebuffer.pixels.data(), slot.size() * sizeof(uint32_t));
+    produced.store(frame + 1, std::memory_order_release);
+    produced.notify_all();
+}
+
+void FrameExporter::finish() {
+    if (finished) return;
+    finished = true;
+
+    // Publica un cuadro ficticio que el escritor reconoce como final
+    const uint64_t last = produced.load(std::memory_order_relaxed);
+    stopAt.store(last, std::memory_order_relaxed);
+    produced.store(last + 1, std::memory_order_release);
+    produced.notify_all();
+    writer.join();
+
+    if (stream.is_open()) {
+        stream.close();
+        if (!stream && !failed.load()) {
+            error = "no se pudo cerrar " + path;
+            failed.store(true);
+        }
+    }
+    if (failed.load()) throw runtime_error("Exportación fallida: " + error);
+}
+
+void FrameExporter::write() {
+    TRACE_THREAD("exporter");
+    for (uint64_t frame = 0; ; ++frame) {
+        uint64_t ready = produced.load(std::memory_order_acquire);
+        while (ready < frame + 1) {
+            produced.wait(ready, std::memory_order_acquire);
+            ready = produced.load(std::memory_order_acquire);
+        }
+        if (frame == stopAt.load(std::memory_order_relaxed)) return;
+
+        // Tras un fallo se siguen liberando búferes para que el render no se bloquee
+        if (!failed.load(std::memory_order_relaxed)) {
+            TRACE_ZONE("export.write");
+            writeFrame(slots[frame % EXPORT_RING_SLOTS], frame);
+        }
+
+        consumed.store(frame + 1, std::memory_order_release);
+        consumed.notify_all();
+    }
+}
+
+void FrameExporter::writeFrame(const vector<uint32_t>& pixels, const uint64_t frame) {
+    const size_t count = pixels.size();
+    uint8_t* out = encoded.data();
+
+    if (format == ExportFormat::Raw) {
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t p = pixels[i];
+            out[4 * i + 0] = uint8_t(p >> 16);
+            out[4 * i + 1] = uint8_t(p >> 8);
+            out[4 * i + 2] = uint8_t(p);
+            out[4 * i + 3] = uint8_t(p >> 24);
+        }
+    }
+    else if (format == ExportFormat::Ppm) {
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t p = pixels[i];
+            out[3 * i + 0] = uint8_t(p >> 16);
+            out[3 * i + 1] = uint8_t(p >> 8);
+            out[3 * i + 2] = uint8_t(p);
+        }
+    }
+    else {
+        // Planos Y, Cb y Cr completos (BT.601, rango limitado)
+        uint8_t* planeY = out;
+        uint8_t* planeU = out + count;
+        uint8_t* planeV = out + 2 * count;
+        for (size_t i = 0; i < count; ++i) {
+            const int r = int((pixels[i] >> 16) & 0xFF);
+            const int g = int((pixels[i] >> 8) & 0xFF);
+            const int b = int(pixels[i] & 0xFF);
+            planeY[i] = uint8_t(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            planeU[i] = uint8_t(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            planeV[i] = uint8_t(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    if (format == ExportFormat::Ppm) {
+        // Un archivo por cuadro; el nombre se arma en la pila
+        char name[4096];
+        snprintf(name, sizeof(name), "%s_%06llu.ppm", path.c_str(), static_cast<unsigned long long>(frame));
+        char header[64];
+        const int headerSize = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", int(width), int(height));
+
+        ofstream file(name, ios::binary);
+        file.write(header, headerSize);
+        file.write(reinterpret_cast<const char*>(out), streamsize(encoded.size()));
+        if (!file) {
+            error = string("no se pudo escribir ") + name;
+            failed.store(true, std::memory_order_release);
+            return;
+        }
+        written += uint64_t(headerSize) + encoded.size();
+        return;
+    }
+
+    if (format == ExportFormat::Y4m) {
+        stream.write("FRAME\n", 6);
+        written += 6;
+    }
+    stream.write(reinterpret_cast<const char*>(out), streamsize(encoded.size()));
+    if (!stream) {
+        error = "no se pudo escribir " + path;
+        failed.store(true, std::memory_order_release);
+        return;
+    }
+    written += encoded.size();
+}
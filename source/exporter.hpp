@@ -0,0 +1,67 @@
+/**
+ * exporter.hpp
+ * Exportación de cuadros a disco en un hilo escritor
+ *
+ * El hilo de render copia cada cuadro a un anillo acotado de búferes
+ * reutilizables (un productor, un consumidor, sin candados); el hilo
+ * escritor convierte el formato y escribe a disco. Ningún cuadro reserva
+ * memoria: todos los búferes se crean al abrir la exportación.
+ */
+
+#pragma once
+#include "framebuffer.hpp"
+
+// Búferes de cuadro en el anillo entre el render y el escritor
+constexpr int EXPORT_RING_SLOTS = 4;
+
+// Formato de salida
+enum class ExportFormat {
+    Raw,    // Un archivo con todos los cuadros en RGBA de 8 bits
+    Ppm,    // Un archivo PPM (P6) por cuadro: <ruta>_000000.ppm, ...
+    Y4m     // Flujo YUV4MPEG2 4:4:4 (lo leen ffmpeg y mpv)
+};
+
+// Escritor asíncrono de cuadros
+class FrameExporter {
+public:
+    // Abre la salida y arranca el hilo escritor; deltaTime fija la tasa de cuadros del Y4M
+    FrameExporter(const string& path, const ExportFormat format, const uint16_t width, const uint16_t height, const float deltaTime);
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    // Copia el cuadro al anillo; sólo espera si el escritor va EXPORT_RING_SLOTS cuadros atrás
+    void submit(const Framebuffer& framebuffer);
+
+    // Espera a que se escriban todos los cuadros; lanza una excepción si falló la escritura
+    void finish();
+
+    uint64_t framesWritten() const { return consumed.load(); }
+    uint64_t bytesWritten() const { return written.load(); }
+    double stallTime() const { return stall; }
+
+private:
+    // Bucle del hilo escritor
+    void write();
+
+    // Convierte un cuadro al formato de salida y lo escribe
+    void writeFrame(const vector<uint32_t>& pixels, const uint64_t frame);
+
+    const string path;
+    const ExportFormat format;
+    const uint16_t width;
+    const uint16_t height;
+    array<vector<uint32_t>, EXPORT_RING_SLOTS> slots;  // Cuadros copiados del render
+    vector<uint8_t> encoded;                            // Cuadro convertido (sólo lo usa el escritor)
+    ofstream stream;                                    // Salida de raw / y4m
+    string error;                                       // Motivo del fallo (lo escribe el escritor)
+    std::atomic<uint64_t> produced{0};                  // Cuadros copiados al anillo
+    std::atomic<uint64_t> consumed{0};                  // Cuadros ya escritos (su búfer se puede reutilizar)
+    std::atomic<uint64_t> stopAt{UINT64_MAX};           // Cuadro ficticio que indica el final
+    std::atomic<uint64_t> written{0};                   // Bytes escritos
+    std::atomic<bool> failed{false};
+    double stall = 0.0;                                 // Tiempo que el render esperó al escritor
+    bool finished = false;
+    std::thread writer;
+};
@@ -0,0 +1,128 @@
+#include "fractal.hpp"
+#include "framebuffer.hpp"
+
+#if defined(__AVX2__)
+    #define FRACTAL_AVX2
+    #include <immintrin.h>
+#endif
+
+// Color de los píxeles dentro del fractal
+static constexpr uint32_t FRACTAL_COLOR = 0xFFFFFFFFu;
+
+FractalUniforms computeFractalUniforms(const Framebuffer& framebuffer, const FractalSettings& settings, const float time) {
+    FractalUniforms uniforms;
+    uniforms.rotateCos = 2.1f * cos(time);
+    uniforms.rotateSin = 2.1f * sin(time);
+    uniforms.pixelScale = 10.0f / float(framebuffer.width) * (sin(time) * 0.5f + 1.5f);
+    uniforms.center = vec2(framebuffer.width, framebuffer.height) / 2.0f;
+    uniforms.iterations = settings.maxIterations;
+    return uniforms;
+}
+
+#if defined(FRACTAL_AVX2)
+
+// Evalúa 8 muestras de una fila (x0, x0 + step, ...) y devuelve la máscara de aciertos
+static inline uint32_t fractalMask8(const FractalUniforms& u, const float x0, const float step, const float y) {
+    const __m256 lanes = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 c = _mm256_set1_ps(u.rotateCos);
+    const __m256 s = _mm256_set1_ps(u.rotateSin);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    const __m256 px = _mm256_add_ps(_mm256_set1_ps(x0), _mm256_mul_ps(lanes, _mm256_set1_ps(step)));
+    __m256 ux = _mm256_mul_ps(_mm256_sub_ps(px, _mm256_set1_ps(u.center.x)), _mm256_set1_ps(u.pixelScale));
+    __m256 uy = _mm256_set1_ps((y - u.center.y) * u.pixelScale);
+
+    for (int i = 0; i < u.iterations; i++) {
+        const __m256 rx = _mm256_sub_ps(_mm256_mul_ps(ux, c), _mm256_mul_ps(uy, s));
+        const __m256 ry = _mm256_add_ps(_mm256_mul_ps(uy, c), _mm256_mul_ps(ux, s));
+        ux = _mm256_sub_ps(_mm256_and_ps(rx, absMask), half);
+        uy = _mm256_sub_ps(_mm256_and_ps(ry, absMask), half);
+    }
+
+    const __m256 lengthSq = _mm256_add_ps(_mm256_mul_ps(ux, ux), _mm256_mul_ps(uy, uy));
+    return uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(lengthSq, _mm256_set1_ps(0.16f), _CMP_LE_OQ)));
+}
+
+#else
+
+// Evalúa 8 muestras de una fila como grupo de carriles que el compilador puede vectorizar
+static inline uint32_t fractalMask8(const FractalUniforms& u, const float x0, const float step, const float y) {
+    float ux[8], uy[8];
+    for (int lane = 0; lane < 8; lane++) {
+        ux[lane] = (x0 + float(lane) * step - u.center.x) * u.pixelScale;
+        uy[lane] = (y - u.center.y) * u.pixelScale;
+    }
+
+    for (int i = 0; i < u.iterations; i++) {
+        for (int lane = 0; lane < 8; lane++) {
+            const float rx = ux[lane] * u.rotateCos - uy[lane] * u.rotateSin;
+            const float ry = uy[lane] * u.rotateCos + ux[lane] * u.rotateSin;
+            ux[lane] = fabsf(rx) - 0.5f;
+            uy[lane] = fabsf(ry) - 0.5f;
+        }
+    }
+
+    uint32_t mask = 0;
+    for (int lane = 0; lane < 8; lane++) {
+        mask |= uint32_t(ux[lane] * ux[lane] + uy[lane] * uy[lane] <= 0.16f) << lane;
+    }
+    return mask;
+}
+
+#endif
+
+void renderFractal(Framebuffer& framebuffer, FractalSettings& settings, const float time) {
+    const double startTime = omp_get_wtime();
+    const FractalUniforms uniforms = computeFractalUniforms(framebuffer, settings, time);
+
+    // Región a cubrir, en coordenadas con el eje y hacia arriba
+    const int resx = framebuffer.width, resy = framebuffer.height;
+    const ivec2 start = settings.fullScreen ? ivec2(0) : ivec2((resx / 2) - (resx / 10), (resy / 2) - (resy / 10));
+    const ivec2 end   = settings.fullScreen ? ivec2(resx, resy) : ivec2((resx / 2) + (resx / 10), (resy / 2) + (resy / 10));
+
+    // Cada muestra cubre un bloque de scale x scale píxeles
+    const int scale = settings.adaptive ? settings.scale : 1;
+    const int cols = (end.x - start.x + scale - 1) / scale;
+    const int rows = (end.y - start.y + scale - 1) / scale;
+    const int bands = (rows + FRACTAL_BAND_ROWS - 1) / FRACTAL_BAND_ROWS;
+    const float offset = float(scale - 1) * 0.5f;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int band = 0; band < bands; band++) {
+        const int rowEnd = std::min((band + 1) * FRACTAL_BAND_ROWS, rows);
+        for (int row = band * FRACTAL_BAND_ROWS; row < rowEnd; row++) {
+            const int y = start.y + row * scale;
+            const int blockRows = std::min(scale, end.y - y);
+
+            for (int col = 0; col < cols; col += 8) {
+                const int x = start.x + col * scale;
+                uint32_t mask = fractalMask8(uniforms, float(x) + offset, float(scale), float(y) + offset);
+                if (col + 8 > cols) mask &= (1u << (cols - col)) - 1u;
+
+                // Escribe los bloques acertados; las filas se invierten como en renderPoint
+                while (mask) {
+                    const int lane = countr_zero(mask);
+                    mask &= mask - 1;
+                    const int bx = x + lane * scale;
+                    const int blockCols = std::min(scale, end.x - bx);
+                    for (int dy = 0; dy < blockRows; dy++) {
+                        uint32_t* pixel = &framebuffer.pixels[size_t(resy - 1 - (y + dy)) * resx + bx];
+                        std::fill(pixel, pixel + blockCols, FRACTAL_COLOR);
+                    }
+                }
+            }
+        }
+    }
+
+    // Ajusta la resolución del siguiente cuadro según el tiempo consumido
+    if (settings.adaptive) {
+        const double elapsed = omp_get_wtime() - startTime;
+        if (elapsed > settings.frameBudget && settings.scale < FRACTAL_MAX_SCALE) {
+            settings.scale *= 2;
+        }
+        else if (elapsed < settings.frameBudget * 0.25 && settings.scale > 1) {
+            settings.scale /= 2;
+        }
+    }
+}
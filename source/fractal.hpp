@@ -0,0 +1,44 @@
+/**
+ * fractal.hpp
+ * Efecto fractal de plegado y rotación
+ *
+ * Los términos que sólo dependen del tiempo se calculan una vez por
+ * cuadro, se evalúan 8 píxeles a la vez y la imagen se reparte en
+ * bandas de filas con planificación dinámica. En modo adaptativo la
+ * resolución baja cuando se excede el presupuesto de tiempo.
+ */
+
+#pragma once
+#include "include.hpp"
+
+struct Framebuffer;
+
+// Filas de resolución reducida que procesa cada tarea
+constexpr int FRACTAL_BAND_ROWS = 4;
+
+// Factor máximo de submuestreo del modo adaptativo
+constexpr int FRACTAL_MAX_SCALE = 4;
+
+// Configuración del fractal
+struct FractalSettings {
+    int maxIterations = 6;              // Iteraciones de plegado
+    bool fullScreen = false;            // Toda la ventana o sólo el recuadro central (20%)
+    bool adaptive = false;              // Ajusta la resolución al presupuesto de tiempo
+    double frameBudget = 1.0 / 240.0;   // Segundos disponibles para el fractal en cada cuadro
+    int scale = 1;                      // Submuestreo actual (1, 2 o 4); lo ajusta el modo adaptativo
+};
+
+// Términos que sólo dependen del tiempo, calculados una vez por cuadro
+struct FractalUniforms {
+    float rotateCos;      // 2.1 * cos(t): escala y rotación combinadas
+    float rotateSin;      // 2.1 * sin(t)
+    float pixelScale;     // Paso de uv por píxel (incluye el zoom sin(t))
+    vec2 center;          // Centro de la pantalla en píxeles
+    int iterations;       // Iteraciones de plegado
+};
+
+// Calcula los uniformes del fractal para un instante
+FractalUniforms computeFractalUniforms(const Framebuffer& framebuffer, const FractalSettings& settings, const float time);
+
+// Dibuja el fractal en el búfer y, en modo adaptativo, ajusta la escala para el siguiente cuadro
+void renderFractal(Framebuffer& framebuffer, FractalSettings& settings, const float time);
@@ -0,0 +1,85 @@
+#include "framebuffer.hpp"
+#include "renderer.hpp"
+
+// Limpia el búfer fila por fila en paralelo
+void clearFramebuffer(Framebuffer& framebuffer, const uint32_t color) {
+    const int height = framebuffer.height;
+
+    #pragma omp parallel for
+    for (int y = 0; y < height; ++y) {
+        uint32_t* row = &framebuffer.pixels[size_t(y) * framebuffer.width];
+        std::fill(row, row + framebuffer.width, color);
+    }
+}
+
+// Dibuja un punto si está dentro de los límites
+void renderPoint(Framebuffer& framebuffer, const uvec2& point, const ivec3& color) {
+    if (point.x < framebuffer.width && point.y < framebuffer.height) {
+        writePixel(framebuffer, int(point.x), framebuffer.height - 1 - int(point.y), packColor(color));
+    }
+}
+
+// Implementa el algoritmo de Bresenham para dibujar una línea
+void renderLine(Framebuffer& framebuffer, const uvec2& pointA, const uvec2& pointB, const ivec3& color) {
+    const int targetX = int(pointB.x);
+    const int targetY = int(pointB.y);
+    const int dx = abs(targetX - int(pointA.x));
+    const int dy = abs(targetY - int(pointA.y));
+    const int stepX = (int(pointA.x) < targetX) ? 1 : -1;
+    const int stepY = (int(pointA.y) < targetY) ? 1 : -1;
+    int err = dx - dy;
+    int x = pointA.x;
+    int y = pointA.y;
+
+    renderPoint(framebuffer, uvec2(x, y), color);
+
+    while (x != targetX || y != targetY) {
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x += stepX;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y += stepY;
+        }
+
+        renderPoint(framebuffer, uvec2(x, y), color);
+    }
+}
+
+// Dibuja un círculo usando el algoritmo de punto medio
+void renderCircle(Framebuffer& framebuffer, const uvec2 center, const uint16_t radius, const ivec3& color) {
+    const uint32_t packed = packColor(color);
+    const int cx = int(center.x);
+    const int cy = int(center.y);
+    int offsetX, offsetY, d;
+    offsetX = 0;
+    offsetY = radius;
+    d = radius - 1;
+
+    while (offsetY >= offsetX) {
+        plotPixel(framebuffer, cx + offsetX, cy + offsetY, packed);
+        plotPixel(framebuffer, cx + offsetY, cy + offsetX, packed);
+        plotPixel(framebuffer, cx - offsetX, cy + offsetY, packed);
+        plotPixel(framebuffer, cx - offsetY, cy + offsetX, packed);
+        plotPixel(framebuffer, cx + offsetX, cy - offsetY, packed);
+        plotPixel(framebuffer, cx + offsetY, cy - offsetX, packed);
+        plotPixel(framebuffer, cx - offsetX, cy - offsetY, packed);
+        plotPixel(framebuffer, cx - offsetY, cy - offsetX, packed);
+
+        if (d >= 2 * offsetX) {
+            d -= 2 * offsetX + 1;
+            offsetX += 1;
+        }
+        else if (d < 2 * (radius - offsetY)) {
+            d += 2 * offsetY - 1;
+            offsetY -= 1;
+        }
+        else {
+            d += 2 * (offsetY - offsetX - 1);
+            offsetY -= 1;
+            offsetX += 1;
+        }
+    }
+}
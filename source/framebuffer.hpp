@@ -0,0 +1,48 @@
+/**
+ * framebuffer.hpp
+ * Búfer de píxeles en memoria para renderizado por software
+ *
+ * Los hilos escriben directamente en un arreglo de uint32_t (ARGB8888)
+ * sin candados; el contenido se sube una vez por cuadro a una textura
+ * SDL_TEXTUREACCESS_STREAMING con SDL_UpdateTexture.
+ */
+
+#pragma once
+#include "include.hpp"
+
+// Búfer de color de la pantalla, fila 0 arriba
+struct Framebuffer {
+    uint16_t width = 0;          // Ancho en píxeles
+    uint16_t height = 0;         // Alto en píxeles
+    vector<uint32_t> pixels;     // Píxeles en formato 0xAARRGGBB
+
+    Framebuffer() = default;
+    Framebuffer(const uint16_t width, const uint16_t height) : width(width), height(height), pixels(size_t(width) * height, 0xFF000000u) {}
+
+    // Número de bytes por fila, para SDL_UpdateTexture
+    int pitch() const { return int(width * sizeof(uint32_t)); }
+};
+
+// Rellena todo el búfer con un color
+void clearFramebuffer(Framebuffer& framebuffer, const uint32_t color);
+
+// Escribe un píxel sin comprobar límites (coordenadas de pantalla, fila 0 arriba)
+inline void writePixel(Framebuffer& framebuffer, const int x, const int y, const uint32_t color) {
+    framebuffer.pixels[size_t(y) * framebuffer.width + x] = color;
+}
+
+// Escribe un píxel si está dentro del búfer
+inline void plotPixel(Framebuffer& framebuffer, const int x, const int y, const uint32_t color) {
+    if (unsigned(x) < framebuffer.width && unsigned(y) < framebuffer.height) {
+        writePixel(framebuffer, x, y, color);
+    }
+}
+
+// Dibuja un punto en el búfer (eje y hacia arriba, como la versión SDL)
+void renderPoint(Framebuffer& framebuffer, const uvec2& point, const ivec3& color);
+
+// Dibuja una línea en el búfer
+void renderLine(Framebuffer& framebuffer, const uvec2& pointA, const uvec2& pointB, const ivec3& color);
+
+// Dibuja el contorno de un círculo en el búfer
+void renderCircle(Framebuffer& framebuffer, const uvec2 center, const uint16_t radius, const ivec3& color);
@@ -0,0 +1,348 @@
+#include "gravity.hpp"
+#include "particles.hpp"
+#include "trace.hpp"
+
+// Intercala los bits de x (posiciones pares) y de y (posiciones impares)
+static inline uint32_t mortonCode(const uint32_t x, const uint32_t y) {
+    auto spread = [](uint32_t v) {
+        v &= 0xFFFFu;
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+// Cuadrante (2 bits) de un código en el nivel dado
+static inline uint32_t quadrantOf(const uint32_t key, const int level) {
+    return (key >> (30 - 2 * level)) & 3u;
+}
+
+// Ordena keys/order por código con un ordenamiento por conteo de 8 bits en 4 pasadas
+static void sortByKey(QuadTree& tree, const int count, const int numThreads) {
+    constexpr int DIGITS = 256;
+    tree.scratchKeys.resize(count);
+    tree.scratchOrder.resize(count);
+    tree.threadCounts.assign(size_t(numThreads) * DIGITS, 0);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        const int thread = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        const int begin = int(int64_t(count) * thread / threads);
+        const int end = int(int64_t(count) * (thread + 1) / threads);
+        uint32_t* counts = &tree.threadCounts[size_t(thread) * DIGITS];
+
+        for (int pass = 0; pass < 4; ++pass) {
+            // Las pasadas pares van de keys a scratch y las impares de vuelta
+            const uint32_t* srcKeys = pass % 2 == 0 ? tree.keys.data() : tree.scratchKeys.data();
+            const uint32_t* srcOrder = pass % 2 == 0 ? tree.order.data() : tree.scratchOrder.data();
+            uint32_t* dstKeys = pass % 2 == 0 ? tree.scratchKeys.data() : tree.keys.data();
+            uint32_t* dstOrder = pass % 2 == 0 ? tree.scratchOrder.data() : tree.order.data();
+            const int shift = pass * 8;
+
+            // Histograma local del dígito
+            std::fill(counts, counts + DIGITS, 0u);
+            for (int i = begin; i < end; ++i) {
+                counts[(srcKeys[i] >> shift) & 0xFF]++;
+            }
+
+            #pragma omp barrier
+
+            // Desplazamiento de cada hilo dentro de cada dígito (pocos dígitos: un solo hilo)
+            #pragma omp single
+            {
+                uint32_t offset = 0;
+                for (int digit = 0; digit < DIGITS; ++digit) {
+                    for (int t = 0; t < threads; ++t) {
+                        uint32_t& slot = tree.threadCounts[size_t(t) * DIGITS + digit];
+                        const uint32_t c = slot;
+                        slot = offset;
+                        offset += c;
+                    }
+                }
+            }
+
+            // Dispersión estable: cada hilo recorre su bloque en orden
+            for (int i = begin; i < end; ++i) {
+                const uint32_t slot = counts[(srcKeys[i] >> shift) & 0xFF]++;
+                dstKeys[slot] = srcKeys[i];
+                dstOrder[slot] = srcOrder[i];
+            }
+
+            #pragma omp barrier
+        }
+    }
+}
+
+// Ordena las partículas por código de Morton y crea el árbol nivel por nivel
+void buildQuadTree(QuadTree& tree, const ParticleSystem& particles) {
+    const int count = int(particles.count);
+    const int numThreads = omp_get_max_threads();
+
+    // Caja que contiene todas las partículas (mínimos y máximos parciales por hilo)
+    vector<vec4> partialBox(numThreads, vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX));
+    #pragma omp parallel num_threads(numThreads)
+    {
+        vec4 box = vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+        #pragma omp for
+        for (int i = 0; i < count; ++i) {
+            box.x = std::min(box.x, particles.positionX[i]);
+            box.y = std::min(box.y, particles.positionY[i]);
+            box.z = std::max(box.z, particles.positionX[i]);
+            box.w = std::max(box.w, particles.positionY[i]);
+        }
+        partialBox[omp_get_thread_num()] = box;
+    }
+    vec4 box = partialBox[0];
+    for (const vec4& partial : partialBox) {
+        box = vec4(min(vec2(box), vec2(partial)), max(vec2(box.z, box.w), vec2(partial.z, partial.w)));
+    }
+    const vec2 origin = count > 0 ? vec2(box) : vec2(0.0f);
+    const float size = count > 0 ? std::max(std::max(box.z - box.x, box.w - box.y), 1.0f) * 1.0001f : 1.0f;
+    const float quantize = 65536.0f / size;
+
+    // Códigos de Morton sobre el cuadrado que contiene la caja
+    tree.keys.resize(count);
+    tree.order.resize(count);
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        const uint32_t qx = uint32_t(glm::clamp(int((particles.positionX[i] - origin.x) * quantize), 0, 65535));
+        const uint32_t qy = uint32_t(glm::clamp(int((particles.positionY[i] - origin.y) * quantize), 0, 65535));
+        tree.keys[i] = mortonCode(qx, qy);
+        tree.order[i] = uint32_t(i);
+    }
+    sortByKey(tree, count, numThreads);
+
+    // Raíz
+    tree.nodes.clear();
+    tree.nodes.push_back({ origin + vec2(size * 0.5f), size * 0.5f, 0.0f, vec2(0.0f), 0, uint32_t(count), -1, 0 });
+    tree.levelStart.assign({ 0, 1 });
+
+    // Cada nivel: contar hijos en paralelo, suma de prefijos y crearlos en paralelo
+    for (int level = 0; level < QUADTREE_MAX_DEPTH; ++level) {
+        const int first = int(tree.levelStart[level]);
+        const int last = int(tree.levelStart[level + 1]);
+        const int levelNodes = last - first;
+        if (levelNodes == 0) break;
+
+        tree.childOffset.resize(levelNodes + 1);
+        tree.childOffset[0] = 0;
+
+        #pragma omp parallel for
+        for (int k = 0; k < levelNodes; ++k) {
+            const QuadNode& node = tree.nodes[first + k];
+            uint32_t children = 0;
+            if (node.end - node.begin > uint32_t(QUADTREE_LEAF_SIZE)) {
+                // Las claves están ordenadas: los cuadrantes presentes aparecen en orden
+                uint32_t previous = 4;
+                for (uint32_t a = node.begin; a < node.end; ) {
+                    const uint32_t quadrant = quadrantOf(tree.keys[a], level);
+                    if (quadrant != previous) {
+                        children++;
+                        previous = quadrant;
+                    }
+                    // Salta al final del cuadrante con búsqueda binaria
+                    a = uint32_t(std::partition_point(tree.keys.begin() + a, tree.keys.begin() + node.end,
+                        [&](const uint32_t key) { return quadrantOf(key, level) == quadrant; }) - tree.keys.begin());
+                }
+            }
+            tree.childOffset[k + 1] = children;
+        }
+
+        for (int k = 0; k < levelNodes; ++k) {
+            tree.childOffset[k + 1] += tree.childOffset[k];
+        }
+        const uint32_t totalChildren = tree.childOffset[levelNodes];
+        if (totalChildren == 0) break;
+
+        tree.nodes.resize(size_t(last) + totalChildren);
+        tree.levelStart.push_back(uint32_t(last) + totalChildren);
+
+        #pragma omp parallel for
+        for (int k = 0; k < levelNodes; ++k) {
+            QuadNode& node = tree.nodes[first + k];
+            const uint32_t children = tree.childOffset[k + 1] - tree.childOffset[k];
+            if (children == 0) continue;
+
+            node.firstChild = int32_t(uint32_t(last) + tree.childOffset[k]);
+            node.childCount = int32_t(children);
+
+            const float quarter = node.halfSize * 0.5f;
+            int32_t child = node.firstChild;
+            for (uint32_t a = node.begin; a < node.end; ++child) {
+                const uint32_t quadrant = quadrantOf(tree.keys[a], level);
+                const uint32_t b = uint32_t(std::partition_point(tree.keys.begin() + a, tree.keys.begin() + node.end,
+                    [&](const uint32_t key) { return quadrantOf(key, level) == quadrant; }) - tree.keys.begin());
+                const vec2 offset = vec2((quadrant & 1u) ? quarter : -quarter, (quadrant & 2u) ? quarter : -quarter);
+                tree.nodes[child] = { node.center + offset, quarter, 0.0f, vec2(0.0f), a, b, -1, 0 };
+                a = b;
+            }
+        }
+    }
+
+    // Masa y centro de masa, de las hojas hacia la raíz
+    const int levels = int(tree.levelStart.size()) - 1;
+    for (int level = levels - 1; level >= 0; --level) {
+        const int first = int(tree.levelStart[level]);
+        const int last = int(tree.levelStart[level + 1]);
+
+        #pragma omp parallel for
+        for (int n = first; n < last; ++n) {
+            QuadNode& node = tree.nodes[n];
+            float mass = 0.0f;
+            vec2 moment = vec2(0.0f);
+            if (node.firstChild < 0) {
+                for (uint32_t a = node.begin; a < node.end; ++a) {
+                    const uint32_t i = tree.order[a];
+                    mass += particles.mass[i];
+                    moment += particles.mass[i] * vec2(particles.positionX[i], particles.positionY[i]);
+                }
+            }
+            else {
+                for (int32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+                    mass += tree.nodes[c].mass;
+                    moment += tree.nodes[c].mass * tree.nodes[c].massCenter;
+                }
+            }
+            node.mass = mass;
+            node.massCenter = mass > 0.0f ? moment / mass : node.center;
+        }
+    }
+
+    // Hojas en orden de Morton: vecinas en la lista son vecinas en el espacio
+    tree.leaves.clear();
+    for (uint32_t n = 0; n < uint32_t(tree.nodes.size()); ++n) {
+        if (tree.nodes[n].firstChild < 0) tree.leaves.push_back(n);
+    }
+    std::sort(tree.leaves.begin(), tree.leaves.end(), [&](const uint32_t a, const uint32_t b) {
+        return tree.nodes[a].begin < tree.nodes[b].begin;
+    });
+}
+
+// Aceleración que produce una masa puntual, con suavizado
+static inline vec2 attraction(const vec2& offset, const float mass, const float softeningSq) {
+    const float distanceSq = dot(offset, offset) + softeningSq;
+    return offset * (mass / (distanceSq * sqrt(distanceSq)));
+}
+
+// Recorre el árbol para una partícula abriendo los nodos demasiado cercanos
+static vec2 treeAcceleration(const QuadTree& tree, const ParticleSystem& particles, const uint32_t self, const float thetaSq, const float softeningSq) {
+    const vec2 position = vec2(particles.positionX[self], particles.positionY[self]);
+    vec2 acceleration = vec2(0.0f);
+
+    // Cada nivel apila a lo sumo 4 hijos: 4 * profundidad alcanza
+    int32_t stack[4 * (QUADTREE_MAX_DEPTH + 1)];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const QuadNode& node = tree.nodes[stack[--top]];
+        if (node.mass <= 0.0f) continue;
+
+        const vec2 offset = node.massCenter - position;
+        const float side = 2.0f * node.halfSize;
+
+        if (side * side < thetaSq * dot(offset, offset)) {
+            // Lo bastante lejos: el nodo completo actúa como una masa puntual
+            acceleration += attraction(offset, node.mass, softeningSq);
+        }
+        else if (node.firstChild < 0) {
+            // Hoja cercana: suma directa
+            for (uint32_t a = node.begin; a < node.end; ++a) {
+                const uint32_t j = tree.order[a];
+                if (j == self) continue;
+                acceleration += attraction(vec2(particles.positionX[j], particles.positionY[j]) - position, particles.mass[j], softeningSq);
+            }
+        }
+        else {
+            for (int32_t c = node.firstChild + node.childCount - 1; c >= node.firstChild; --c) {
+                stack[top++] = c;
+            }
+        }
+    }
+    return acceleration;
+}
+
+// Cada hilo empieza por su bloque de hojas y al terminarlo roba de los demás
+void computeBarnesHut(QuadTree& tree, const ParticleSystem& particles, const GravitySettings& settings) {
+    const uint32_t numLeaves = uint32_t(tree.leaves.size());
+    const int numThreads = omp_get_max_threads();
+    const float thetaSq = settings.theta * settings.theta;
+    const float softeningSq = settings.softening * settings.softening;
+
+    tree.acceleration.resize(particles.count);
+    if (tree.rangeCount < numThreads) {
+        tree.ranges.reset(new StealRange[numThreads]);
+        tree.rangeCount = numThreads;
+    }
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        const int thread = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+
+        StealRange& own = tree.ranges[thread];
+        own.next.store(uint32_t(uint64_t(numLeaves) * thread / threads), std::memory_order_relaxed);
+        own.end = uint32_t(uint64_t(numLeaves) * (thread + 1) / threads);
+
+        #pragma omp barrier
+
+        TRACE_ZONE("gravity.thread");
+        for (int v = 0; v < threads; ++v) {
+            StealRange& range = tree.ranges[(thread + v) % threads];
+            for (;;) {
+                const uint32_t begin = range.next.fetch_add(GRAVITY_STEAL_GRAIN, std::memory_order_relaxed);
+                if (begin >= range.end) break;
+                const uint32_t end = std::min(begin + GRAVITY_STEAL_GRAIN, range.end);
+
+                for (uint32_t l = begin; l < end; ++l) {
+                    const QuadNode& leaf = tree.nodes[tree.leaves[l]];
+                    for (uint32_t a = leaf.begin; a < leaf.end; ++a) {
+                        const uint32_t i = tree.order[a];
+                        tree.acceleration[i] = settings.strength * treeAcceleration(tree, particles, i, thetaSq, softeningSq);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Suma directa de todos los pares; cada hilo escribe sólo sus propias partículas
+void computeBruteForce(vector<vec2>& acceleration, const ParticleSystem& particles, const GravitySettings& settings) {
+    const int count = int(particles.count);
+    const float softeningSq = settings.softening * settings.softening;
+    acceleration.resize(count);
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        const vec2 position = vec2(particles.positionX[i], particles.positionY[i]);
+        vec2 sum = vec2(0.0f);
+        for (int j = 0; j < count; ++j) {
+            if (j == i) continue;
+            sum += attraction(vec2(particles.positionX[j], particles.positionY[j]) - position, particles.mass[j], softeningSq);
+        }
+        acceleration[i] = settings.strength * sum;
+    }
+}
+
+void applyGravity(ParticleSystem& particles, QuadTree& tree, const GravitySettings& settings, const float& deltaTime) {
+    if (settings.mode == GravityMode::Off || particles.count == 0) return;
+
+    if (settings.mode == GravityMode::BarnesHut) {
+        buildQuadTree(tree, particles);
+        computeBarnesHut(tree, particles, settings);
+    }
+    else {
+        computeBruteForce(tree.acceleration, particles, settings);
+    }
+
+    const int count = int(particles.count);
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        particles.velocityX[i] += tree.acceleration[i].x * deltaTime;
+        particles.velocityY[i] += tree.acceleration[i].y * deltaTime;
+    }
+}
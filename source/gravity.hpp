@@ -0,0 +1,85 @@
+/**
+ * gravity.hpp
+ * Atracción gravitatoria entre partículas (Barnes-Hut)
+ *
+ * Cada cuadro se ordenan las partículas por código de Morton y se
+ * construye un árbol cuaternario nivel por nivel, en paralelo. La fuerza
+ * sobre cada partícula aproxima los nodos lejanos por su centro de masa
+ * según el ángulo de apertura theta; el reparto de hojas entre hilos usa
+ * robo de trabajo. Se conserva el cálculo directo O(n²) como referencia.
+ */
+
+#pragma once
+#include "include.hpp"
+
+struct ParticleSystem;
+
+// Forma de calcular la gravedad, elegida en tiempo de ejecución
+enum class GravityMode {
+    Off,          // Sin gravedad (trayectorias rectas)
+    BarnesHut,    // Árbol cuaternario con aproximación por centro de masa
+    BruteForce    // Suma directa de todos los pares (referencia de precisión)
+};
+
+// Partículas máximas en una hoja del árbol
+constexpr int QUADTREE_LEAF_SIZE = 8;
+
+// Profundidad máxima (16 bits de código de Morton por eje)
+constexpr int QUADTREE_MAX_DEPTH = 16;
+
+// Hojas que toma un hilo en cada reclamo de trabajo
+constexpr uint32_t GRAVITY_STEAL_GRAIN = 4;
+
+// Parámetros de la gravedad
+struct GravitySettings {
+    GravityMode mode = GravityMode::Off;
+    float theta = 0.5f;         // Ángulo de apertura (0 = exacto)
+    float strength = 100.0f;    // Constante gravitatoria en px³ / (masa · s²)
+    float softening = 4.0f;     // Suavizado en píxeles para evitar singularidades
+};
+
+// Nodo del árbol cuaternario
+struct QuadNode {
+    vec2 center;            // Centro del cuadrado
+    float halfSize;         // Mitad del lado
+    float mass;             // Masa total contenida
+    vec2 massCenter;        // Centro de masa
+    uint32_t begin;         // Primera partícula (índice en QuadTree::order)
+    uint32_t end;           // Una después de la última
+    int32_t firstChild;     // Primer hijo (los hijos son consecutivos), -1 en hojas
+    int32_t childCount;     // Número de hijos no vacíos
+};
+
+// Rango de hojas de un hilo; el dueño y los ladrones reclaman desde el frente
+struct alignas(64) StealRange {
+    std::atomic<uint32_t> next{ 0 };
+    uint32_t end = 0;
+};
+
+// Árbol cuaternario y memoria auxiliar que se reutiliza entre cuadros
+struct QuadTree {
+    vector<QuadNode> nodes;           // Nodos ordenados por nivel
+    vector<uint32_t> levelStart;      // Primer nodo de cada nivel (niveles + 1 entradas)
+    vector<uint32_t> leaves;          // Hojas, en orden de Morton (unidades de trabajo)
+    vector<uint32_t> keys;            // Código de Morton de cada partícula ordenada
+    vector<uint32_t> order;           // Índices de partículas ordenados por código
+    vector<uint32_t> scratchKeys;     // Búfer auxiliar del ordenamiento
+    vector<uint32_t> scratchOrder;    // Búfer auxiliar del ordenamiento
+    vector<uint32_t> threadCounts;    // Histogramas por hilo del ordenamiento
+    vector<uint32_t> childOffset;     // Hijos por nodo del nivel en construcción
+    vector<vec2> acceleration;        // Aceleración calculada por partícula
+    unique_ptr<StealRange[]> ranges;  // Colas de hojas por hilo
+    int rangeCount = 0;               // Tamaño de ranges
+};
+
+// Construye el árbol con las posiciones actuales de las partículas
+void buildQuadTree(QuadTree& tree, const ParticleSystem& particles);
+
+// Calcula la aceleración de cada partícula recorriendo el árbol (tree.acceleration)
+void computeBarnesHut(QuadTree& tree, const ParticleSystem& particles, const GravitySettings& settings);
+
+// Calcula la aceleración exacta sumando todos los pares
+void computeBruteForce(vector<vec2>& acceleration, const ParticleSystem& particles, const GravitySettings& settings);
+
+// Acelera las partículas según el modo elegido
+void applyGravity(ParticleSystem& particles, QuadTree& tree, const GravitySettings& settings, const float& deltaTime);
@@ -3,19 +3,24 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <filesystem>
-#include <windows.h>
 #include <stdexcept>
+#include <algorithm>
 #include <iostream>
 #include <optional>
-#include <direct.h>
+#include <memory>
+#include <atomic>
+#include <thread>
 #include <stdint.h>
+#include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <fstream>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <cfloat>
 #include <numeric>
+#include <bit>
 #include <cerrno>
 #include <vector>
 #include <math.h>
@@ -25,7 +30,14 @@
 #include <array>
 #include <map>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#endif
+
+#ifndef PARALELA_HEADLESS
 #include <SDL.h>
+#endif
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/rotate_vector.hpp>
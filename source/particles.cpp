@@ -0,0 +1,341 @@
+#include "particles.hpp"
+#include "renderer.hpp"
+
+#if defined(__AVX2__)
+    #define PARTICLES_AVX2
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define PARTICLES_SSE
+    #include <emmintrin.h>
+#endif
+
+// Números aleatorios que consume cada partícula creada
+static constexpr uint64_t PARTICLE_RANDOM_DRAWS = 5;
+
+ParticleSystem::ParticleSystem(size_t count, size_t maxCapacity) : maxCapacity(maxCapacity) {
+    resize(count);
+}
+
+ParticleSystem::ParticleSystem(ParticleSystem&& other) noexcept {
+    *this = std::move(other);
+}
+
+ParticleSystem& ParticleSystem::operator=(ParticleSystem&& other) noexcept {
+    // El intercambio deja al otro objeto a cargo de liberar las reservas anteriores
+    std::swap(count, other.count);
+    std::swap(capacity, other.capacity);
+    std::swap(maxCapacity, other.maxCapacity);
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        std::swap(arenas[f], other.arenas[f]);
+    }
+    bindFields();
+    other.bindFields();
+    return *this;
+}
+
+// Apunta cada campo al inicio de su reserva
+void ParticleSystem::bindFields() {
+    positionX = reinterpret_cast<float*>(arenas[0].data());
+    positionY = reinterpret_cast<float*>(arenas[1].data());
+    velocityX = reinterpret_cast<float*>(arenas[2].data());
+    velocityY = reinterpret_cast<float*>(arenas[3].data());
+    displayRadius = reinterpret_cast<float*>(arenas[4].data());
+    radius = reinterpret_cast<float*>(arenas[5].data());
+    mass = reinterpret_cast<float*>(arenas[6].data());
+    color = reinterpret_cast<uint32_t*>(arenas[7].data());
+}
+
+// Confirma bloques nuevos al crecer; los arreglos nunca cambian de dirección
+void ParticleSystem::resize(size_t newCount) {
+    const size_t newPadded = (newCount + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+    if (newPadded <= capacity) {
+        count = newCount;
+        return;
+    }
+    if (newPadded > maxCapacity) {
+        throw runtime_error("Demasiadas partículas: " + to_string(newCount) + " (máximo " + to_string(maxCapacity) + ")");
+    }
+
+    // La reserva completa se hace al primer crecimiento
+    if (!arenas[0].data()) {
+        for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+            arenas[f] = VirtualArena(maxCapacity * sizeof(float));
+        }
+        bindFields();
+    }
+
+    // Las páginas recién confirmadas empiezan a cero, así que el relleno queda limpio
+    const size_t newCapacity = std::min((newPadded + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK * PARTICLE_CHUNK, maxCapacity);
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        arenas[f].commit(newCapacity * sizeof(float));
+    }
+    capacity = newCapacity;
+    count = newCount;
+}
+
+// Empieza con reservas nuevas y proyecta el archivo al inicio de cada una
+void ParticleSystem::mapFields(const MappableFile& file, const uint64_t offsets[PARTICLE_FIELDS], const size_t fieldBytes, const size_t newCount) {
+    // fieldBytes / 4 es múltiplo de PARTICLE_LANES, así que también cabe el relleno (sin multiplicar count)
+    if (newCount > fieldBytes / sizeof(float) || fieldBytes / sizeof(float) > maxCapacity) {
+        throw runtime_error("Demasiadas partículas: " + to_string(newCount) + " (máximo " + to_string(maxCapacity) + ")");
+    }
+
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        arenas[f] = VirtualArena(maxCapacity * sizeof(float));
+        arenas[f].mapFile(file, offsets[f], fieldBytes);
+    }
+    bindFields();
+
+    // Crecer después confirma memoria anónima a continuación de lo proyectado
+    capacity = fieldBytes / sizeof(float);
+    count = newCount;
+}
+
+// Mueve la última partícula al hueco y limpia su posición anterior
+void ParticleSystem::swapRemove(size_t index) {
+    const size_t last = count - 1;
+    float* fields[PARTICLE_FIELDS] = {
+        positionX, positionY, velocityX, velocityY,
+        displayRadius, radius, mass, reinterpret_cast<float*>(color)
+    };
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        fields[f][index] = fields[f][last];
+        fields[f][last] = 0.0f;
+    }
+    count = last;
+}
+
+// Copia campo por campo, incluido el relleno que recorren los kernels
+void copyParticles(ParticleSystem& destination, const ParticleSystem& source) {
+    destination.resize(source.count);
+    const size_t bytes = source.padded() * sizeof(float);
+
+    std::memcpy(destination.positionX, source.positionX, bytes);
+    std::memcpy(destination.positionY, source.positionY, bytes);
+    std::memcpy(destination.velocityX, source.velocityX, bytes);
+    std::memcpy(destination.velocityY, source.velocityY, bytes);
+    std::memcpy(destination.displayRadius, source.displayRadius, bytes);
+    std::memcpy(destination.radius, source.radius, bytes);
+    std::memcpy(destination.mass, source.mass, bytes);
+    std::memcpy(destination.color, source.color, bytes);
+}
+
+// Cada partícula usa su propio tramo del contador, así que los hilos no comparten estado
+size_t spawnParticles(ParticleSystem& particles, const size_t n, const vec2& bounds, CounterRng& random) {
+    const size_t first = particles.count;
+    particles.resize(first + n);
+
+    const uint32_t resx = uint32_t(bounds.x);
+    const uint32_t resy = uint32_t(bounds.y);
+    const CounterRng base = random;
+    const int total = int(n);
+
+    #pragma omp parallel for
+    for (int i = 0; i < total; ++i) {
+        CounterRng rng(base.seed, base.counter + uint64_t(i) * PARTICLE_RANDOM_DRAWS);
+        const size_t p = first + size_t(i);
+        particles.positionX[p] = float(rng.below(resx));
+        particles.positionY[p] = float(rng.below(resy));
+        particles.velocityX[p] = float(int(rng.below(500)) - 250);
+        particles.velocityY[p] = float(int(rng.below(500)) - 250);
+        particles.radius[p] = float(rng.below(6) + 1);
+        particles.displayRadius[p] = 0.0f;
+        particles.mass[p] = pi<float>() * particles.radius[p] * particles.radius[p];
+        particles.color[p] = 0xFFFFFFFFu;
+    }
+
+    random.counter += uint64_t(n) * PARTICLE_RANDOM_DRAWS;
+    return first;
+}
+
+// Elimina de mayor a menor índice para que cada intercambio no invalide los pendientes
+void despawnParticles(ParticleSystem& particles, vector<uint32_t> indices) {
+    std::sort(indices.begin(), indices.end(), std::greater<uint32_t>());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for (const uint32_t index : indices) {
+        if (index < particles.count) particles.swapRemove(index);
+    }
+}
+
+#if defined(PARTICLES_AVX2)
+
+// Multiplicación y suma, fusionada cuando el compilador habilita FMA
+static inline __m256 madd(__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// Seno vectorial: reducción a [-PI/2, PI/2] y polinomio de grado 9
+static inline __m256 sin8(__m256 x) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 turns = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(INVERTED_PI * 0.5f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = madd(turns, _mm256_set1_ps(-TWO_PI), x);
+
+    const __m256 signedPi = _mm256_or_ps(_mm256_and_ps(x, signMask), _mm256_set1_ps(PI));
+    const __m256 folded = _mm256_cmp_ps(_mm256_andnot_ps(signMask, x), _mm256_set1_ps(PI * 0.5f), _CMP_GT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_sub_ps(signedPi, x), folded);
+
+    const __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 p = _mm256_set1_ps(1.0f / 362880.0f);
+    p = madd(p, x2, _mm256_set1_ps(-1.0f / 5040.0f));
+    p = madd(p, x2, _mm256_set1_ps(1.0f / 120.0f));
+    p = madd(p, x2, _mm256_set1_ps(-1.0f / 6.0f));
+    p = madd(p, x2, _mm256_set1_ps(1.0f));
+    return _mm256_mul_ps(p, x);
+}
+
+void integrateParticles(ParticleSystem& particles, const vec2& bounds, const float& deltaTime, const float& time) {
+    const int padded = int(particles.padded());
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 phase = _mm256_set1_ps(time * 0.001f / (bounds.x * bounds.y));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 amplitude = _mm256_set1_ps(0.8f);
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; i += 8) {
+        const __m256 px = madd(_mm256_load_ps(particles.velocityX + i), dt, _mm256_load_ps(particles.positionX + i));
+        const __m256 py = madd(_mm256_load_ps(particles.velocityY + i), dt, _mm256_load_ps(particles.positionY + i));
+        const __m256 pulsate = madd(sin8(_mm256_mul_ps(_mm256_mul_ps(phase, px), py)), amplitude, one);
+
+        _mm256_store_ps(particles.positionX + i, px);
+        _mm256_store_ps(particles.positionY + i, py);
+        _mm256_store_ps(particles.displayRadius + i, _mm256_mul_ps(_mm256_load_ps(particles.radius + i), pulsate));
+    }
+}
+
+// Acota una coordenada a [r, bound - r] e invierte la velocidad si la tocó
+static inline void reflect8(float* position, float* velocity, const __m256 r, const __m256 bound) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 p = _mm256_load_ps(position);
+    const __m256 high = _mm256_sub_ps(bound, r);
+    const __m256 hit = _mm256_or_ps(_mm256_cmp_ps(p, r, _CMP_LT_OQ), _mm256_cmp_ps(p, high, _CMP_GT_OQ));
+
+    _mm256_store_ps(position, _mm256_min_ps(_mm256_max_ps(p, r), high));
+    _mm256_store_ps(velocity, _mm256_xor_ps(_mm256_load_ps(velocity), _mm256_and_ps(hit, signMask)));
+}
+
+void reflectParticles(ParticleSystem& particles, const vec2& bounds) {
+    const int padded = int(particles.padded());
+    const __m256 boundX = _mm256_set1_ps(bounds.x);
+    const __m256 boundY = _mm256_set1_ps(bounds.y);
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; i += 8) {
+        const __m256 r = _mm256_load_ps(particles.radius + i);
+        reflect8(particles.positionX + i, particles.velocityX + i, r, boundX);
+        reflect8(particles.positionY + i, particles.velocityY + i, r, boundY);
+    }
+}
+
+const char* particleKernelName() {
+    return "AVX2";
+}
+
+#elif defined(PARTICLES_SSE)
+
+// Seno vectorial: reducción a [-PI/2, PI/2] y polinomio de grado 9
+static inline __m128 sin4(__m128 x) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(INVERTED_PI * 0.5f))));
+    x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(TWO_PI)));
+
+    const __m128 signedPi = _mm_or_ps(_mm_and_ps(x, signMask), _mm_set1_ps(PI));
+    const __m128 folded = _mm_cmpgt_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(PI * 0.5f));
+    x = _mm_or_ps(_mm_and_ps(folded, _mm_sub_ps(signedPi, x)), _mm_andnot_ps(folded, x));
+
+    const __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_set1_ps(1.0f / 362880.0f);
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 5040.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 120.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 6.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(p, x);
+}
+
+void integrateParticles(ParticleSystem& particles, const vec2& bounds, const float& deltaTime, const float& time) {
+    const int padded = int(particles.padded());
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 phase = _mm_set1_ps(time * 0.001f / (bounds.x * bounds.y));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 amplitude = _mm_set1_ps(0.8f);
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; i += 4) {
+        const __m128 px = _mm_add_ps(_mm_load_ps(particles.positionX + i), _mm_mul_ps(_mm_load_ps(particles.velocityX + i), dt));
+        const __m128 py = _mm_add_ps(_mm_load_ps(particles.positionY + i), _mm_mul_ps(_mm_load_ps(particles.velocityY + i), dt));
+        const __m128 pulsate = _mm_add_ps(_mm_mul_ps(sin4(_mm_mul_ps(_mm_mul_ps(phase, px), py)), amplitude), one);
+
+        _mm_store_ps(particles.positionX + i, px);
+        _mm_store_ps(particles.positionY + i, py);
+        _mm_store_ps(particles.displayRadius + i, _mm_mul_ps(_mm_load_ps(particles.radius + i), pulsate));
+    }
+}
+
+// Acota una coordenada a [r, bound - r] e invierte la velocidad si la tocó
+static inline void reflect4(float* position, float* velocity, const __m128 r, const __m128 bound) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 p = _mm_load_ps(position);
+    const __m128 high = _mm_sub_ps(bound, r);
+    const __m128 hit = _mm_or_ps(_mm_cmplt_ps(p, r), _mm_cmpgt_ps(p, high));
+
+    _mm_store_ps(position, _mm_min_ps(_mm_max_ps(p, r), high));
+    _mm_store_ps(velocity, _mm_xor_ps(_mm_load_ps(velocity), _mm_and_ps(hit, signMask)));
+}
+
+void reflectParticles(ParticleSystem& particles, const vec2& bounds) {
+    const int padded = int(particles.padded());
+    const __m128 boundX = _mm_set1_ps(bounds.x);
+    const __m128 boundY = _mm_set1_ps(bounds.y);
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; i += 4) {
+        const __m128 r = _mm_load_ps(particles.radius + i);
+        reflect4(particles.positionX + i, particles.velocityX + i, r, boundX);
+        reflect4(particles.positionY + i, particles.velocityY + i, r, boundY);
+    }
+}
+
+const char* particleKernelName() {
+    return "SSE2";
+}
+
+#else
+
+void integrateParticles(ParticleSystem& particles, const vec2& bounds, const float& deltaTime, const float& time) {
+    const int padded = int(particles.padded());
+    const float phase = time * 0.001f / (bounds.x * bounds.y);
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; ++i) {
+        particles.positionX[i] += particles.velocityX[i] * deltaTime;
+        particles.positionY[i] += particles.velocityY[i] * deltaTime;
+        particles.displayRadius[i] = particles.radius[i] * (1.0f + sin(phase * particles.positionX[i] * particles.positionY[i]) * 0.8f);
+    }
+}
+
+void reflectParticles(ParticleSystem& particles, const vec2& bounds) {
+    const int padded = int(particles.padded());
+
+    #pragma omp parallel for
+    for (int i = 0; i < padded; ++i) {
+        const float r = particles.radius[i];
+        const float x = particles.positionX[i];
+        const float y = particles.positionY[i];
+        const bool hitX = (x < r) | (x > bounds.x - r);
+        const bool hitY = (y < r) | (y > bounds.y - r);
+
+        particles.positionX[i] = std::min(std::max(x, r), bounds.x - r);
+        particles.positionY[i] = std::min(std::max(y, r), bounds.y - r);
+        particles.velocityX[i] = hitX ? -particles.velocityX[i] : particles.velocityX[i];
+        particles.velocityY[i] = hitY ? -particles.velocityY[i] : particles.velocityY[i];
+    }
+}
+
+const char* particleKernelName() {
+    return "Escalar";
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * particles.hpp
+ * Almacenamiento de partículas como estructura de arreglos (SoA)
+ *
+ * Cada campo vive en su propio arreglo alineado a 64 bytes y con
+ * relleno hasta un múltiplo de PARTICLE_LANES, de modo que los
+ * kernels AVX2/SSE recorren los datos sin bifurcaciones ni colas.
+ *
+ * Cada arreglo ocupa una reserva de memoria virtual propia que se
+ * confirma por bloques de PARTICLE_CHUNK partículas: crecer, crear o
+ * eliminar partículas nunca mueve ni copia el conjunto completo.
+ */
+
+#pragma once
+#include "include.hpp"
+#include "arena.hpp"
+#include "random.hpp"
+
+// Alineación de cada arreglo (una línea de caché)
+constexpr size_t PARTICLE_ALIGNMENT = 64;
+
+// Ancho de relleno de los arreglos (un registro AVX de floats)
+constexpr size_t PARTICLE_LANES = 8;
+
+// Partículas que se confirman de una vez al crecer (256 KB por campo)
+constexpr size_t PARTICLE_CHUNK = 65536;
+
+// Número de campos de 4 bytes almacenados por partícula
+constexpr size_t PARTICLE_FIELDS = 8;
+
+// Máximo de partículas por sistema (sólo reserva espacio de direcciones)
+constexpr size_t PARTICLE_MAX_CAPACITY = sizeof(void*) == 8 ? size_t(1) << 26 : size_t(1) << 22;
+
+// Conjunto de partículas con un arreglo por campo
+struct ParticleSystem {
+    size_t count = 0;              // Partículas activas
+    size_t capacity = 0;           // Partículas con memoria confirmada (múltiplo de PARTICLE_LANES)
+    size_t maxCapacity = PARTICLE_MAX_CAPACITY;  // Partículas que caben en la reserva
+
+    // Campos calientes: se leen y escriben cada cuadro
+    float* positionX = nullptr;
+    float* positionY = nullptr;
+    float* velocityX = nullptr;
+    float* velocityY = nullptr;
+    float* displayRadius = nullptr;
+
+    // Campos fríos o de sólo lectura en la integración
+    float* radius = nullptr;
+    float* mass = nullptr;
+    uint32_t* color = nullptr;     // Color empaquetado 0xAARRGGBB
+
+    ParticleSystem() = default;
+    explicit ParticleSystem(size_t count, size_t maxCapacity = PARTICLE_MAX_CAPACITY);
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+    ParticleSystem(ParticleSystem&& other) noexcept;
+    ParticleSystem& operator=(ParticleSystem&& other) noexcept;
+
+    // Cambia el número de partículas conservando las existentes (confirma bloques nuevos si hace falta)
+    void resize(size_t newCount);
+
+    // Elimina una partícula moviendo la última a su lugar
+    void swapRemove(size_t index);
+
+    // Proyecta los arreglos desde un archivo sin copiarlos (un desplazamiento por campo, en el
+    // orden de los miembros); cada campo ocupa fieldBytes. Reemplaza el contenido actual.
+    void mapFields(const MappableFile& file, const uint64_t offsets[PARTICLE_FIELDS], const size_t fieldBytes, const size_t newCount);
+
+    // Número de elementos que recorren los kernels (count redondeado a PARTICLE_LANES)
+    size_t padded() const { return (count + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES; }
+
+private:
+    void bindFields();
+
+    VirtualArena arenas[PARTICLE_FIELDS];  // Una reserva por campo
+};
+
+// Copia todas las partículas de un sistema a otro, reutilizando su memoria si cabe
+void copyParticles(ParticleSystem& destination, const ParticleSystem& source);
+
+// Añade n partículas aleatorias al final (posición, velocidad y radio aleatorios); devuelve el primer índice
+size_t spawnParticles(ParticleSystem& particles, const size_t n, const vec2& bounds, CounterRng& random);
+
+// Elimina las partículas indicadas sin reordenar ni copiar el resto del conjunto (ignora repetidos
+// e índices fuera de rango; las últimas ocupan los huecos)
+void despawnParticles(ParticleSystem& particles, vector<uint32_t> indices);
+
+// Integra posiciones y calcula el radio de pulsación en una sola pasada
+void integrateParticles(ParticleSystem& particles, const vec2& bounds, const float& deltaTime, const float& time);
+
+// Refleja las partículas que salen de los bordes de la pantalla
+void reflectParticles(ParticleSystem& particles, const vec2& bounds);
+
+// Nombre del conjunto de instrucciones usado por los kernels
+const char* particleKernelName();
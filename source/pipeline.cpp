@@ -0,0 +1,131 @@
+#include "pipeline.hpp"
+
+FramePipeline::FramePipeline(Scene& scene, const float fixedDeltaTime)
+    : scene(scene), fixedDeltaTime(fixedDeltaTime), threads(omp_get_max_threads()), producerThreads(std::max(threads / 2, 1)) {
+    copyParticles(initial, scene.particles);
+    for (PipelineSlot& slot : slots) {
+        slot.background = Framebuffer(scene.framebuffer.width, scene.framebuffer.height);
+    }
+    worker = std::thread(&FramePipeline::produce, this);
+}
+
+FramePipeline::~FramePipeline() {
+    // Despierta al productor si está esperando un estado libre
+    running.store(false);
+    consumed.fetch_add(1);
+    consumed.notify_all();
+    worker.join();
+
+    // El productor nunca alcanza el estado del último cuadro rasterizado (hay PIPELINE_DEPTH + 1)
+    if (nextFrame > 0) {
+        const PipelineState& state = states[(nextFrame - 1) % (PIPELINE_DEPTH + 1)];
+        copyParticles(scene.particles, state.particles);
+        scene.time = state.time;
+        scene.frame += nextFrame;
+    }
+    omp_set_num_threads(threads);
+}
+
+void FramePipeline::produce() {
+    TRACE_THREAD("pipeline");
+    double lastTime = wallTime();
+    double time = scene.time;
+
+    for (uint64_t frame = 0; ; ++frame) {
+        // El fondo de este cuadro se reutiliza cuando el cuadro frame - PIPELINE_DEPTH ya se rasterizó;
+        // su estado de partículas es el del cuadro frame - PIPELINE_DEPTH - 1, anterior a ése
+        uint64_t done = consumed.load(std::memory_order_acquire);
+        if (done + PIPELINE_DEPTH < frame + 1) {
+            TRACE_WAIT("pipeline.wait_consumed");
+            while (running.load() && done + PIPELINE_DEPTH < frame + 1) {
+                consumed.wait(done, std::memory_order_acquire);
+                done = consumed.load(std::memory_order_acquire);
+            }
+        }
+        if (!running.load()) return;
+
+        const int frameThreads = producerThreads.load(std::memory_order_relaxed);
+        omp_set_num_threads(frameThreads);
+
+        const double now = wallTime();
+        const float deltaTime = fixedDeltaTime > 0.0f ? fixedDeltaTime : (frame == 0 ? 1.0f / 60.0f : float(now - lastTime));
+        lastTime = now;
+
+        PipelineSlot& slot = slots[frame % PIPELINE_DEPTH];
+        PipelineState& state = states[frame % (PIPELINE_DEPTH + 1)];
+        const ParticleSystem& previous = frame == 0 ? initial : states[(frame - 1) % (PIPELINE_DEPTH + 1)].particles;
+        slot.times = StageTimes();
+        slot.threads = frameThreads;
+
+        // Simula a partir del cuadro anterior (que el consumidor puede estar leyendo a la vez)
+        double stageStart = wallTime();
+        {
+            TRACE_ZONE("simulate");
+            copyParticles(state.particles, previous);
+            simulateParticles(state.particles, scene.simulation, scene.bounds, deltaTime, float(time) * 1000.0f);
+        }
+        double stageEnd = wallTime();
+        slot.times.simulate = stageEnd - stageStart;
+
+        // Fractal del mismo cuadro, en paralelo con el rasterizado del cuadro actual
+        {
+            TRACE_ZONE("fractal");
+            clearFramebuffer(slot.background, 0xFF000000u);
+            renderFractal(slot.background, scene.fractal, float(time));
+        }
+        slot.times.fractal = wallTime() - stageEnd;
+
+        time += deltaTime;
+        state.time = time;
+        produced.store(frame + 1, std::memory_order_release);
+        produced.notify_all();
+    }
+}
+
+void FramePipeline::renderFrame(StageTimes& times) {
+    const uint64_t frame = nextFrame++;
+
+    // Espera a que el productor publique el cuadro
+    uint64_t ready = produced.load(std::memory_order_acquire);
+    if (ready < frame + 1) {
+        TRACE_WAIT("pipeline.wait_produced");
+        while (ready < frame + 1) {
+            produced.wait(ready, std::memory_order_acquire);
+            ready = produced.load(std::memory_order_acquire);
+        }
+    }
+
+    const PipelineSlot& slot = slots[frame % PIPELINE_DEPTH];
+    const ParticleSystem& particles = states[frame % (PIPELINE_DEPTH + 1)].particles;
+    times.simulate += slot.times.simulate;
+    times.fractal += slot.times.fractal;
+
+    // Compone el fondo y rasteriza las partículas de este cuadro con los hilos que no usa el productor
+    const int rasterThreads = std::max(threads - producerThreads.load(std::memory_order_relaxed), 1);
+    omp_set_num_threads(rasterThreads);
+    const double stageStart = wallTime();
+    {
+        TRACE_ZONE("raster");
+        std::memcpy(scene.framebuffer.pixels.data(), slot.background.pixels.data(), scene.framebuffer.pixels.size() * sizeof(uint32_t));
+        binCircles(scene.bins, particles, scene.framebuffer, scene.circleMode);
+        rasterizeCircles(scene.framebuffer, scene.bins, particles, scene.circleMode);
+    }
+    const double rasterTime = wallTime() - stageStart;
+    times.raster += rasterTime;
+    balanceThreads(slot, rasterTime, rasterThreads);
+
+    // Libera el fondo: la presentación ya no lo necesita
+    consumed.store(frame + 1, std::memory_order_release);
+    consumed.notify_all();
+}
+
+void FramePipeline::balanceThreads(const PipelineSlot& slot, const double rasterTime, const int rasterThreads) {
+    // Suponiendo escalado lineal, el tiempo de cada etapa por sus hilos es su trabajo
+    producerWork += PIPELINE_BALANCE_SMOOTHING * ((slot.times.simulate + slot.times.fractal) * slot.threads - producerWork);
+    rasterWork += PIPELINE_BALANCE_SMOOTHING * (rasterTime * rasterThreads - rasterWork);
+    if (threads < 2 || producerWork + rasterWork <= 0.0) return;
+
+    // Cada etapa conserva al menos un hilo
+    const int split = int(std::lround(threads * producerWork / (producerWork + rasterWork)));
+    producerThreads.store(std::clamp(split, 1, threads - 1), std::memory_order_relaxed);
+}
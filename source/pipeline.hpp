@@ -0,0 +1,72 @@
+/**
+ * pipeline.hpp
+ * Tubería de cuadros con estado de partículas en varios búferes
+ *
+ * Un hilo de trabajo simula el cuadro N+1 y dibuja su fractal mientras
+ * el hilo principal rasteriza y presenta el cuadro N. La sincronización
+ * entre ambos usa dos contadores atómicos (producido / consumido) en
+ * lugar de una barrera después de cada etapa. Los hilos OpenMP del
+ * creador se reparten entre las dos etapas según el trabajo medido, para
+ * no lanzar dos equipos completos a la vez.
+ */
+
+#pragma once
+#include "scene.hpp"
+
+// Número de estados de partículas en vuelo (2 = doble búfer, 3 = triple)
+constexpr int PIPELINE_DEPTH = 2;
+
+// Peso de cada cuadro en la media móvil del trabajo de las etapas
+constexpr double PIPELINE_BALANCE_SMOOTHING = 0.1;
+
+// Partículas de un cuadro ya simulado
+struct PipelineState {
+    ParticleSystem particles;   // Partículas del cuadro
+    double time = 0.0;          // Tiempo de la escena tras simular este cuadro
+};
+
+// Fondo de un cuadro ya simulado
+struct PipelineSlot {
+    Framebuffer background;     // Fractal del cuadro, listo para componer
+    StageTimes times;           // Tiempo de simulación y fractal medido por el productor
+    int threads = 1;            // Hilos con los que se produjo
+};
+
+// Tubería productor (simulación + fractal) / consumidor (rasterizado + presentación)
+class FramePipeline {
+public:
+    // Toma el estado inicial de scene.particles; fixedDeltaTime <= 0 usa el reloj de pared
+    FramePipeline(Scene& scene, const float fixedDeltaTime);
+
+    // Devuelve a la escena el estado del último cuadro rasterizado (el mismo que dejaría renderScene),
+    // así el resultado no depende de cuánto se adelantó el productor, y restaura los hilos del creador
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Espera el siguiente cuadro, lo compone en scene.framebuffer y libera su estado
+    void renderFrame(StageTimes& times);
+
+private:
+    // Bucle del hilo productor
+    void produce();
+
+    // Reparte los hilos en proporción al trabajo (hilo-segundos por cuadro) de cada etapa
+    void balanceThreads(const PipelineSlot& slot, const double rasterTime, const int rasterThreads);
+
+    Scene& scene;
+    const float fixedDeltaTime;
+    const int threads;                  // Hilos OpenMP del creador, repartidos entre productor y consumidor
+    std::atomic<int> producerThreads;   // Hilos del productor (los fija el consumidor; cada std::thread empieza con el valor por defecto)
+    double producerWork = 0.0;          // Media móvil de hilo-segundos por cuadro del productor
+    double rasterWork = 0.0;            // Media móvil de hilo-segundos por cuadro del rasterizado
+    array<PipelineSlot, PIPELINE_DEPTH> slots;
+    array<PipelineState, PIPELINE_DEPTH + 1> states;  // Uno más que slots: el último cuadro rasterizado no se sobrescribe
+    ParticleSystem initial;             // Estado anterior al primer cuadro
+    std::atomic<uint64_t> produced{0};  // Cuadros listos para rasterizar
+    std::atomic<uint64_t> consumed{0};  // Cuadros ya rasterizados (su estado se puede reutilizar)
+    std::atomic<bool> running{true};
+    uint64_t nextFrame = 0;             // Siguiente cuadro del consumidor
+    std::thread worker;
+};
@@ -0,0 +1,36 @@
+/**
+ * random.hpp
+ * Generador aleatorio basado en contador
+ *
+ * Cada número es una función pura de (semilla, contador), así que cualquier
+ * hilo puede generar la secuencia de cualquier partícula sin estado global
+ * compartido, y el resultado no depende del número de hilos.
+ */
+
+#pragma once
+#include "include.hpp"
+
+// Mezcla de SplitMix64 aplicada a un contador
+inline uint64_t mixCounter(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Estado del generador: semilla fija y contador que avanza con cada número
+struct CounterRng {
+    uint64_t seed = 1;
+    uint64_t counter = 0;
+
+    CounterRng() = default;
+    CounterRng(const uint64_t seed, const uint64_t counter = 0) : seed(seed), counter(counter) {}
+
+    // Siguiente número de 64 bits
+    uint64_t next() { return mixCounter(seed * 0x9E3779B97F4A7C15ull + mixCounter(counter++)); }
+
+    // Entero uniforme en [0, range)
+    uint32_t below(const uint32_t range) { return uint32_t(((next() >> 32) * range) >> 32); }
+
+    // Flotante uniforme en [0, 1)
+    float uniform() { return float(next() >> 40) * (1.0f / 16777216.0f); }
+};
@@ -0,0 +1,238 @@
+#include "rasterizer.hpp"
+#include "framebuffer.hpp"
+#include "particles.hpp"
+#include "trace.hpp"
+
+// Rectángulo de píxeles [x0, x1) x [y0, y1)
+struct PixelRect {
+    int x0, y0, x1, y1;
+};
+
+// Caja envolvente en píxeles de un círculo según el modo de dibujo
+static inline PixelRect circleBounds(const ParticleSystem& particles, const size_t i, const CircleMode mode) {
+    if (mode == CircleMode::Outline) {
+        // Mismo redondeo que renderCircle: centro y radio enteros
+        const int cx = int(particles.positionX[i]);
+        const int cy = int(particles.positionY[i]);
+        const int r = int(particles.displayRadius[i]);
+        return { cx - r, cy - r, cx + r + 1, cy + r + 1 };
+    }
+    const float r = particles.displayRadius[i] + 1.0f;
+    return {
+        int(floor(particles.positionX[i] - r)), int(floor(particles.positionY[i] - r)),
+        int(ceil(particles.positionX[i] + r)) + 1, int(ceil(particles.positionY[i] + r)) + 1
+    };
+}
+
+// Rango de teselas [tx0, tx1] x [ty0, ty1] que toca una caja; vacío si queda fuera
+static inline bool tileRange(const TileBins& bins, const PixelRect& box, const Framebuffer& framebuffer, ivec4& range) {
+    if (box.x1 <= 0 || box.y1 <= 0 || box.x0 >= framebuffer.width || box.y0 >= framebuffer.height) return false;
+    range = ivec4(
+        std::max(box.x0, 0) / TILE_SIZE, std::max(box.y0, 0) / TILE_SIZE,
+        std::min((box.x1 - 1) / TILE_SIZE, bins.tilesX - 1), std::min((box.y1 - 1) / TILE_SIZE, bins.tilesY - 1)
+    );
+    return true;
+}
+
+// Agrupa los círculos por tesela conservando el orden original dentro de cada una
+void binCircles(TileBins& bins, const ParticleSystem& particles, const Framebuffer& framebuffer, const CircleMode mode) {
+    const int count = int(particles.count);
+
+    bins.tilesX = (framebuffer.width + TILE_SIZE - 1) / TILE_SIZE;
+    bins.tilesY = (framebuffer.height + TILE_SIZE - 1) / TILE_SIZE;
+
+    const int numTiles = bins.tilesX * bins.tilesY;
+    const int numThreads = omp_get_max_threads();
+
+    bins.tileStart.assign(numTiles + 1, 0);
+    bins.threadCounts.assign(size_t(numThreads) * numTiles, 0);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        TRACE_ZONE("bin.thread");
+
+        // Cada hilo procesa siempre el mismo bloque contiguo de partículas
+        const int thread = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        const int begin = int(int64_t(count) * thread / threads);
+        const int end = int(int64_t(count) * (thread + 1) / threads);
+        uint32_t* counts = &bins.threadCounts[size_t(thread) * numTiles];
+        ivec4 range;
+
+        // Histograma local de referencias por tesela
+        for (int i = begin; i < end; ++i) {
+            if (!tileRange(bins, circleBounds(particles, i, mode), framebuffer, range)) continue;
+            for (int ty = range.y; ty <= range.w; ++ty) {
+                for (int tx = range.x; tx <= range.z; ++tx) {
+                    counts[ty * bins.tilesX + tx]++;
+                }
+            }
+        }
+
+        // Espera a que todos los hilos terminen su histograma
+        {
+            TRACE_WAIT("bin.barrier");
+            #pragma omp barrier
+        }
+
+        // Total de referencias por tesela
+        #pragma omp for
+        for (int tile = 0; tile < numTiles; ++tile) {
+            uint32_t total = 0;
+            for (int t = 0; t < threads; ++t) {
+                total += bins.threadCounts[size_t(t) * numTiles + tile];
+            }
+            bins.tileStart[tile + 1] = total;
+        }
+
+        // Suma de prefijos y reserva de la lista de referencias
+        #pragma omp single
+        {
+            for (int tile = 0; tile < numTiles; ++tile) {
+                bins.tileStart[tile + 1] += bins.tileStart[tile];
+            }
+            bins.tileEntries.resize(bins.tileStart[numTiles]);
+        }
+
+        // Desplazamiento de cada hilo dentro de cada tesela
+        #pragma omp for
+        for (int tile = 0; tile < numTiles; ++tile) {
+            uint32_t offset = bins.tileStart[tile];
+            for (int t = 0; t < threads; ++t) {
+                uint32_t& slot = bins.threadCounts[size_t(t) * numTiles + tile];
+                const uint32_t c = slot;
+                slot = offset;
+                offset += c;
+            }
+        }
+
+        // Dispersión sin conflictos
+        for (int i = begin; i < end; ++i) {
+            if (!tileRange(bins, circleBounds(particles, i, mode), framebuffer, range)) continue;
+            for (int ty = range.y; ty <= range.w; ++ty) {
+                for (int tx = range.x; tx <= range.z; ++tx) {
+                    bins.tileEntries[counts[ty * bins.tilesX + tx]++] = uint32_t(i);
+                }
+            }
+        }
+    }
+}
+
+// Escribe un píxel sólo si cae dentro de la tesela
+static inline void plotClipped(Framebuffer& framebuffer, const PixelRect& clip, const int x, const int y, const uint32_t color) {
+    if (x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1) {
+        writePixel(framebuffer, x, y, color);
+    }
+}
+
+// Mezcla un color sobre el píxel existente con la cobertura dada
+static inline uint32_t blendColor(const uint32_t dst, const uint32_t src, const float coverage) {
+    const uint32_t a = uint32_t(coverage * 256.0f);
+    const uint32_t rb = (((src & 0xFF00FFu) * a + (dst & 0xFF00FFu) * (256 - a)) >> 8) & 0xFF00FFu;
+    const uint32_t g = (((src & 0x00FF00u) * a + (dst & 0x00FF00u) * (256 - a)) >> 8) & 0x00FF00u;
+    return 0xFF000000u | rb | g;
+}
+
+// Contorno por punto medio recortado a la tesela
+static void outlineCircle(Framebuffer& framebuffer, const PixelRect& clip, const int cx, const int cy, const int radius, const uint32_t color) {
+    int offsetX = 0;
+    int offsetY = radius;
+    int d = radius - 1;
+
+    while (offsetY >= offsetX) {
+        plotClipped(framebuffer, clip, cx + offsetX, cy + offsetY, color);
+        plotClipped(framebuffer, clip, cx + offsetY, cy + offsetX, color);
+        plotClipped(framebuffer, clip, cx - offsetX, cy + offsetY, color);
+        plotClipped(framebuffer, clip, cx - offsetY, cy + offsetX, color);
+        plotClipped(framebuffer, clip, cx + offsetX, cy - offsetY, color);
+        plotClipped(framebuffer, clip, cx + offsetY, cy - offsetX, color);
+        plotClipped(framebuffer, clip, cx - offsetX, cy - offsetY, color);
+        plotClipped(framebuffer, clip, cx - offsetY, cy - offsetX, color);
+
+        if (d >= 2 * offsetX) {
+            d -= 2 * offsetX + 1;
+            offsetX += 1;
+        }
+        else if (d < 2 * (radius - offsetY)) {
+            d += 2 * offsetY - 1;
+            offsetY -= 1;
+        }
+        else {
+            d += 2 * (offsetY - offsetX - 1);
+            offsetY -= 1;
+            offsetX += 1;
+        }
+    }
+}
+
+// Disco relleno por intervalos horizontales recortados a la tesela
+static void fillCircle(Framebuffer& framebuffer, const PixelRect& clip, const vec2 center, const float radius, const uint32_t color) {
+    const int y0 = std::max(int(floor(center.y - radius)), clip.y0);
+    const int y1 = std::min(int(ceil(center.y + radius)) + 1, clip.y1);
+
+    for (int y = y0; y < y1; ++y) {
+        const float dy = float(y) + 0.5f - center.y;
+        const float spanSq = radius * radius - dy * dy;
+        if (spanSq < 0.0f) continue;
+
+        const float span = sqrt(spanSq);
+        const int x0 = std::max(int(ceil(center.x - span - 0.5f)), clip.x0);
+        const int x1 = std::min(int(floor(center.x + span - 0.5f)) + 1, clip.x1);
+        if (x0 >= x1) continue;
+
+        uint32_t* row = &framebuffer.pixels[size_t(y) * framebuffer.width];
+        std::fill(row + x0, row + x1, color);
+    }
+}
+
+// Disco relleno con cobertura por distancia al borde
+static void antialiasCircle(Framebuffer& framebuffer, const PixelRect& clip, const vec2 center, const float radius, const uint32_t color) {
+    const int x0 = std::max(int(floor(center.x - radius - 1.0f)), clip.x0);
+    const int x1 = std::min(int(ceil(center.x + radius + 1.0f)) + 1, clip.x1);
+    const int y0 = std::max(int(floor(center.y - radius - 1.0f)), clip.y0);
+    const int y1 = std::min(int(ceil(center.y + radius + 1.0f)) + 1, clip.y1);
+
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = &framebuffer.pixels[size_t(y) * framebuffer.width];
+        const float dy = float(y) + 0.5f - center.y;
+        for (int x = x0; x < x1; ++x) {
+            const float dx = float(x) + 0.5f - center.x;
+            const float coverage = radius + 0.5f - sqrt(dx * dx + dy * dy);
+            if (coverage <= 0.0f) continue;
+            row[x] = coverage >= 1.0f ? color : blendColor(row[x], color, coverage);
+        }
+    }
+}
+
+// Cada tesela la rasteriza un único hilo, por lo que no hay escrituras compartidas
+void rasterizeCircles(Framebuffer& framebuffer, const TileBins& bins, const ParticleSystem& particles, const CircleMode mode) {
+    const int numTiles = bins.tilesX * bins.tilesY;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int tile = 0; tile < numTiles; ++tile) {
+        TRACE_ZONE("raster.tile");
+        const int tx = tile % bins.tilesX;
+        const int ty = tile / bins.tilesX;
+        const PixelRect clip = {
+            tx * TILE_SIZE, ty * TILE_SIZE,
+            std::min((tx + 1) * TILE_SIZE, int(framebuffer.width)), std::min((ty + 1) * TILE_SIZE, int(framebuffer.height))
+        };
+
+        for (uint32_t e = bins.tileStart[tile]; e < bins.tileStart[tile + 1]; ++e) {
+            const uint32_t i = bins.tileEntries[e];
+            const uint32_t color = particles.color[i];
+
+            switch (mode) {
+                case CircleMode::Outline:
+                    outlineCircle(framebuffer, clip, int(particles.positionX[i]), int(particles.positionY[i]), int(particles.displayRadius[i]), color);
+                    break;
+                case CircleMode::Filled:
+                    fillCircle(framebuffer, clip, vec2(particles.positionX[i], particles.positionY[i]), particles.displayRadius[i], color);
+                    break;
+                case CircleMode::Antialiased:
+                    antialiasCircle(framebuffer, clip, vec2(particles.positionX[i], particles.positionY[i]), particles.displayRadius[i], color);
+                    break;
+            }
+        }
+    }
+}
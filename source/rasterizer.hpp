@@ -0,0 +1,39 @@
+/**
+ * rasterizer.hpp
+ * Rasterizador de círculos por teselas (tiles) con agrupamiento previo
+ *
+ * Primero se asigna cada círculo a las teselas de pantalla que toca y
+ * después cada tesela se rasteriza por un único hilo, de modo que dos
+ * hilos nunca escriben el mismo píxel y no hacen falta atómicos.
+ */
+
+#pragma once
+#include "include.hpp"
+
+struct ParticleSystem;
+struct Framebuffer;
+
+// Lado de cada tesela en píxeles
+constexpr int TILE_SIZE = 64;
+
+// Forma de dibujar cada círculo
+enum class CircleMode {
+    Outline,      // Contorno por punto medio (como renderCircle)
+    Filled,       // Disco relleno
+    Antialiased   // Disco relleno con borde suavizado
+};
+
+// Listas de círculos por tesela construidas por ordenamiento por conteo
+struct TileBins {
+    int tilesX = 0;                 // Teselas por fila
+    int tilesY = 0;                 // Teselas por columna
+    vector<uint32_t> tileStart;     // Inicio de cada tesela en tileEntries (tilesX * tilesY + 1)
+    vector<uint32_t> tileEntries;   // Índices de partículas por tesela, en orden de dibujo
+    vector<uint32_t> threadCounts;  // Histogramas por hilo (hilos * teselas)
+};
+
+// Asigna cada círculo a las teselas que cubre su caja envolvente
+void binCircles(TileBins& bins, const ParticleSystem& particles, const Framebuffer& framebuffer, const CircleMode mode);
+
+// Rasteriza todas las teselas en paralelo, un hilo por tesela
+void rasterizeCircles(Framebuffer& framebuffer, const TileBins& bins, const ParticleSystem& particles, const CircleMode mode);
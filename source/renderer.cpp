@@ -1,5 +1,6 @@
 #include "renderer.hpp"
 
+#ifndef PARALELA_HEADLESS
 // Dibuja un punto en la pantalla si está dentro de los límites
 void renderPoint(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy, const uvec2& point, const ivec3& color) {
     if (point.x < resx && point.x >= 0 && point.y < resy && point.y >= 0) {
@@ -9,7 +10,7 @@ void renderPoint(SDL_Renderer* renderer, const uint16_t resx, const uint16_t res
 }
 
 // Implementa el algoritmo de Bresenham para dibujar una línea
-void renderLine(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy, const uvec2& pointA, uvec2& pointB, const ivec3& color) {
+void renderLine(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy, const uvec2& pointA, const uvec2& pointB, const ivec3& color) {
     int dx = abs(pointB.x - pointA.x);
     int dy = abs(pointB.y - pointA.y);
     int err = dx - dy;
@@ -67,6 +68,8 @@ void renderCircle(SDL_Renderer* renderer, const uint16_t resx, const uint16_t re
     }
 }
 
+#endif
+
 // Crea una matriz de rotación 2D
 mat2 rot(float a) {
     float c = cos(a);
@@ -74,19 +77,6 @@ mat2 rot(float a) {
     return mat2(c, -s, s, c);
 }
 
-// Inicializa un conjunto de círculos con propiedades aleatorias
-vector<Circle> initializeCircles(const uint16_t& numCircles, const uint16_t resx, const uint16_t resy) {
-    vector<Circle> circles(numCircles);
-    for (uint16_t i = 0; i < numCircles; ++i) {
-        circles[i].position = vec2(rand() % resx, rand() % resy);
-        circles[i].velocity = vec2((rand() % 500) - 250, (rand() % 500) - 250);
-        circles[i].radius = (rand() % 6) + 1;
-        circles[i].mass = pi<float>() * pow(circles[i].radius, 2);
-        circles[i].color = ivec3(255,255,255);
-    }
-    return circles;
-}
-
 // Maneja las colisiones de un círculo con los bordes de la pantalla
 void checkBoundingBoxCollision(Circle& circle, const vec2& bounds) {
     for (int i = 0; i < 2; ++i) {
@@ -102,39 +92,45 @@ void checkBoundingBoxCollision(Circle& circle, const vec2& bounds) {
 }
 
 // Genera un patrón de color basado en la posición y el tiempo
+// (sin caché: recalcula el término del tiempo en cada llamada; ver shadeParticles)
 vec3 getPattern(const vec2& position, const vec2& bounds, const float& radius, const float& deltaTime, const float& time) {
-    vec3 colorPattern = vec3(1.0);
-    vec2 normalizedPos = position / bounds;
+    const ShadeUniforms uniforms = { 1.0f / bounds, patternBlue(time) };
+    return getPattern(position.x / bounds.x, radius, uniforms);
+}
 
-    colorPattern.x *= 1.0f - (radius * 0.05f);
-    colorPattern.y *= normalizedPos.x + (radius * 0.05f);
+// Actualiza todas las partículas con los kernels vectoriales
+void simulateParticles(ParticleSystem& particles, SimulationContext& context, const vec2& bounds, const float& deltaTime, const float& time) {
+    // Atracción entre partículas (sólo si está activada)
+    if (context.gravity.mode != GravityMode::Off) {
+        TRACE_ZONE("gravity");
+        applyGravity(particles, context.tree, context.gravity, deltaTime);
+    }
 
-    float z_val = 0.0;
-    for (int i = 0; i < 10000; i++) {
-        z_val += sin(time * 0.0001f) * 0.8f / 10000.0f;
+    // Integración y pulsación
+    {
+        TRACE_ZONE("integrate");
+        integrateParticles(particles, bounds, deltaTime, time);
     }
 
-    colorPattern.z *= z_val;
+    // Actualiza color con los uniformes del cuadro
+    {
+        TRACE_ZONE("shade");
+        shadeParticles(particles, context.shading, bounds, time);
+    }
 
-    return max(min(colorPattern, vec3(1)), vec3(0));
-}
+    // Colisiones entre partículas usando la rejilla espacial
+    {
+        TRACE_ZONE("grid");
+        buildSpatialGrid(context.grid, particles, bounds);
+    }
+    {
+        TRACE_ZONE("collisions");
+        resolveCircleCollisions(particles, context.grid);
+    }
 
-// Actualiza la posición y propiedades de todos los círculos
-void simulateStep(vector<Circle>& circles, const vec2& bounds, const float& deltaTime, const float& time) {
-    #pragma omp parallel for
-    for (int i = 0; i < circles.size(); ++i) {
-        // Actualiza posición
-        circles[i].position += circles[i].velocity * deltaTime;
-        
-        // Efecto de pulsación
-        const float pulsate = 1.0f + sin(time * 0.001f * (circles[i].position.x / bounds.x) * (circles[i].position.y / bounds.y)) * 0.8f;
-        circles[i].display_radius = circles[i].radius * pulsate;
-        
-        // Actualiza color
-        circles[i].color = ivec3(getPattern(circles[i].position, bounds, circles[i].display_radius, deltaTime, time) * 255.0f);
-        
-        // Comprueba colisiones
-        #pragma omp critical
-        checkBoundingBoxCollision(circles[i], bounds);
+    // Comprueba colisiones con los bordes
+    {
+        TRACE_ZONE("reflect");
+        reflectParticles(particles, bounds);
     }
 }
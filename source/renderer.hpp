@@ -8,7 +8,16 @@
 
 #pragma once
 #include "include.hpp"
+#include "spatial_grid.hpp"
+#include "particles.hpp"
+#include "framebuffer.hpp"
+#include "rasterizer.hpp"
+#include "fractal.hpp"
+#include "shading.hpp"
+#include "gravity.hpp"
+#include "trace.hpp"
 
+#ifndef PARALELA_HEADLESS
 // Dibuja un punto en la pantalla
 void renderPoint(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy, const uvec2& point, const ivec3& color);
 
@@ -17,6 +26,7 @@ void renderLine(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy
 
 // Dibuja un círculo en la pantalla
 void renderCircle(SDL_Renderer* renderer, const uint16_t resx, const uint16_t resy, const uvec2 center, const uint16_t radius, const ivec3& color);
+#endif
 
 // Estructura que representa una partícula
 struct Circle {
@@ -28,8 +38,15 @@ struct Circle {
     float mass;           // Masa de la partícula
 };
 
-// Crea un conjunto inicial de partículas
-vector<Circle> initializeCircles(const uint16_t& numCircles, const uint16_t resx, const uint16_t resy);
+// Empaqueta un color RGB en formato 0xAARRGGBB
+inline uint32_t packColor(const ivec3& color) {
+    return 0xFF000000u | (uint32_t(color.x & 0xFF) << 16) | (uint32_t(color.y & 0xFF) << 8) | uint32_t(color.z & 0xFF);
+}
+
+// Desempaqueta un color 0xAARRGGBB a RGB
+inline ivec3 unpackColor(const uint32_t color) {
+    return ivec3((color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+}
 
 // Maneja las colisiones de una partícula con los bordes
 void checkBoundingBoxCollision(Circle& circle, const vec2& bounds);
@@ -37,5 +54,19 @@ void checkBoundingBoxCollision(Circle& circle, const vec2& bounds);
 // Obtiene un patrón de color basado en la posición y tiempo
 vec3 getPattern(const vec2& position, const vec2& bounds, const float& radius, const float& deltaTime, const float& time);
 
-// Actualiza la posición y velocidad de todas las partículas
-void simulateStep(vector<Circle>& circles, const vec2& bounds, const float& deltaTime, const float& time);
+// Patrón de color con los uniformes del cuadro ya calculados (x normalizada en [0, 1])
+inline vec3 getPattern(const float normalizedX, const float radius, const ShadeUniforms& uniforms) {
+    const vec3 colorPattern = vec3(1.0f - (radius * 0.05f), normalizedX + (radius * 0.05f), uniforms.blue);
+    return max(min(colorPattern, vec3(1)), vec3(0));
+}
+
+// Estado auxiliar de la simulación que se reutiliza entre cuadros
+struct SimulationContext {
+    SpatialGrid grid;        // Rejilla para colisiones
+    ShadingCache shading;    // Uniformes y tabla de color del cuadro
+    QuadTree tree;           // Árbol cuaternario de la gravedad
+    GravitySettings gravity; // Modo y parámetros de la gravedad (apagada por defecto)
+};
+
+// Actualiza la posición, color y colisiones de todas las partículas (SoA)
+void simulateParticles(ParticleSystem& particles, SimulationContext& context, const vec2& bounds, const float& deltaTime, const float& time);
@@ -0,0 +1,47 @@
+#include "scene.hpp"
+
+void initializeScene(Scene& scene, const size_t numCircles, const uint16_t resx, const uint16_t resy, const uint64_t seed) {
+    scene.bounds = vec2(resx, resy);
+    scene.framebuffer = Framebuffer(resx, resy);
+    scene.random = CounterRng(seed);
+    scene.time = 0.0;
+    scene.frame = 0;
+    scene.particles.resize(0);
+    spawnParticles(scene.particles, numCircles, scene.bounds, scene.random);
+}
+
+void renderScene(Scene& scene, const float deltaTime, StageTimes& times) {
+    const float time = float(scene.time);
+    double stageStart = wallTime();
+
+    // Limpia el búfer y dibuja el efecto fractal
+    {
+        TRACE_ZONE("fractal");
+        clearFramebuffer(scene.framebuffer, 0xFF000000u);
+        renderFractal(scene.framebuffer, scene.fractal, time);
+    }
+    double stageEnd = wallTime();
+    times.fractal += stageEnd - stageStart;
+    stageStart = stageEnd;
+
+    // Actualiza las partículas (el tiempo de la simulación va en milisegundos)
+    {
+        TRACE_ZONE("simulate");
+        simulateParticles(scene.particles, scene.simulation, scene.bounds, deltaTime, time * 1000.0f);
+    }
+    stageEnd = wallTime();
+    times.simulate += stageEnd - stageStart;
+    stageStart = stageEnd;
+
+    // Dibuja las partículas por teselas
+    {
+        TRACE_ZONE("raster");
+        binCircles(scene.bins, scene.particles, scene.framebuffer, scene.circleMode);
+        rasterizeCircles(scene.framebuffer, scene.bins, scene.particles, scene.circleMode);
+    }
+    times.raster += wallTime() - stageStart;
+
+    // En doble precisión la suma de pasos fijos es exacta: el cuadro N ve siempre el mismo tiempo
+    scene.time += deltaTime;
+    scene.frame++;
+}
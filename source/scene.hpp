@@ -0,0 +1,47 @@
+/**
+ * scene.hpp
+ * Estado de la simulación y ejecución de un cuadro por etapas
+ *
+ * Agrupa todo lo que necesita un cuadro (partículas, rejilla, búfer,
+ * teselas y fractal) para que la ventana SDL y el modo sin ventana
+ * ejecuten exactamente el mismo código y midan las mismas etapas.
+ */
+
+#pragma once
+#include "renderer.hpp"
+
+// Tiempo de reloj (segundos) consumido por cada etapa de un cuadro
+struct StageTimes {
+    double simulate = 0.0;   // Integración, color y colisiones
+    double fractal = 0.0;    // Limpieza del búfer y fractal
+    double raster = 0.0;     // Agrupamiento y rasterizado de círculos
+    double present = 0.0;    // Subida del búfer (textura o copia)
+
+    double total() const { return simulate + fractal + raster + present; }
+};
+
+// Estado completo de la escena
+struct Scene {
+    vec2 bounds;                                  // Tamaño de la pantalla
+    ParticleSystem particles;                     // Partículas (SoA)
+    CounterRng random;                            // Generador para crear partículas
+    double time = 0.0;                            // Tiempo simulado en segundos
+    uint64_t frame = 0;                           // Cuadros simulados
+    SimulationContext simulation;                 // Rejilla y cachés de la simulación
+    Framebuffer framebuffer;                      // Búfer de píxeles
+    TileBins bins;                                // Círculos agrupados por tesela
+    FractalSettings fractal;                      // Configuración del fractal
+    CircleMode circleMode = CircleMode::Outline;  // Forma de dibujar las partículas
+};
+
+// Reloj de pared en segundos (no usa clock(), que suma el tiempo de CPU de todos los hilos)
+inline double wallTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Crea las partículas y el búfer de la escena
+void initializeScene(Scene& scene, const size_t numCircles, const uint16_t resx, const uint16_t resy, const uint64_t seed = 1);
+
+// Ejecuta fractal, simulación y rasterizado del cuadro en scene.time, acumulando el tiempo de cada etapa,
+// y avanza el tiempo de la escena
+void renderScene(Scene& scene, const float deltaTime, StageTimes& times);
@@ -0,0 +1,70 @@
+#include "shading.hpp"
+#include "renderer.hpp"
+
+float patternBlue(const float time) {
+    float z_val = 0.0;
+    for (int i = 0; i < 10000; i++) {
+        z_val += sin(time * 0.0001f) * 0.8f / 10000.0f;
+    }
+    return z_val;
+}
+
+const ShadeUniforms& shadeUniforms(ShadingCache& cache, const vec2& bounds, const float time) {
+    // Un instante o pantalla distintos invalidan los uniformes
+    if (time != cache.time || bounds != cache.bounds) {
+        cache.time = time;
+        cache.bounds = bounds;
+        cache.uniformsReady = false;
+    }
+
+    if (!cache.uniformsReady) {
+        cache.uniforms.inverseBounds = 1.0f / bounds;
+        cache.uniforms.blue = patternBlue(time);
+        cache.uniformsReady = true;
+    }
+    return cache.uniforms;
+}
+
+// Rellena la tabla con el rojo y verde del centro de cada celda; sólo dependen de x normalizada
+// y del radio, así que la tabla sirve para cualquier instante y pantalla
+static void buildShadeLut(ShadingCache& cache) {
+    cache.lut.resize(size_t(SHADE_LUT_POSITIONS) * SHADE_LUT_RADII);
+    const ShadeUniforms uniforms = { vec2(1.0f), 0.0f };
+
+    #pragma omp parallel for
+    for (int r = 0; r < SHADE_LUT_RADII; ++r) {
+        const float radius = (float(r) + 0.5f) * (SHADE_LUT_MAX_RADIUS / SHADE_LUT_RADII);
+        for (int p = 0; p < SHADE_LUT_POSITIONS; ++p) {
+            const float x = (float(p) + 0.5f) / SHADE_LUT_POSITIONS;
+            cache.lut[size_t(r) * SHADE_LUT_POSITIONS + p] = packColor(ivec3(getPattern(x, radius, uniforms) * 255.0f));
+        }
+    }
+}
+
+void shadeParticles(ParticleSystem& particles, ShadingCache& cache, const vec2& bounds, const float time) {
+    const int count = int(particles.count);
+    const ShadeUniforms& uniforms = shadeUniforms(cache, bounds, time);
+
+    if (cache.mode == ShadeMode::Lut) {
+        if (cache.lut.empty()) buildShadeLut(cache);
+
+        // Azul del cuadro, cuantizado igual que en packColor
+        const uint32_t blue = uint32_t(int(glm::clamp(uniforms.blue, 0.0f, 1.0f) * 255.0f) & 0xFF);
+        const float positionScale = uniforms.inverseBounds.x * SHADE_LUT_POSITIONS;
+        const float radiusScale = SHADE_LUT_RADII / SHADE_LUT_MAX_RADIUS;
+
+        #pragma omp parallel for
+        for (int i = 0; i < count; ++i) {
+            const int p = glm::clamp(int(particles.positionX[i] * positionScale), 0, SHADE_LUT_POSITIONS - 1);
+            const int r = glm::clamp(int(particles.displayRadius[i] * radiusScale), 0, SHADE_LUT_RADII - 1);
+            particles.color[i] = cache.lut[size_t(r) * SHADE_LUT_POSITIONS + p] | blue;
+        }
+        return;
+    }
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; ++i) {
+        const float x = particles.positionX[i] * uniforms.inverseBounds.x;
+        particles.color[i] = packColor(ivec3(getPattern(x, particles.displayRadius[i], uniforms) * 255.0f));
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * shading.hpp
+ * Etapa de color de las partículas con uniformes por cuadro
+ *
+ * El término de getPattern que sólo depende del tiempo se evalúa una
+ * única vez por cuadro (y sólo si alguien lo pide); cada partícula
+ * cuesta entonces un par de multiplicaciones y sumas. Opcionalmente el
+ * rojo y el verde salen de una tabla indexada por posición normalizada y
+ * radio, que se construye una sola vez; el azul del cuadro se añade al leerla.
+ */
+
+#pragma once
+#include "include.hpp"
+
+struct ParticleSystem;
+
+// Resolución de la tabla de color: posición x normalizada y radio
+constexpr int SHADE_LUT_POSITIONS = 256;
+constexpr int SHADE_LUT_RADII = 64;
+
+// Radio a partir del cual el color ya está saturado (radius * 0.05 >= 1)
+constexpr float SHADE_LUT_MAX_RADIUS = 20.0f;
+
+// Forma de calcular el color de cada partícula
+enum class ShadeMode {
+    Exact,   // Fórmula de getPattern con los uniformes del cuadro
+    Lut      // Tabla de rojo y verde precalculada, más el azul del cuadro
+};
+
+// Valores compartidos por todas las partículas de un cuadro
+struct ShadeUniforms {
+    vec2 inverseBounds;   // 1 / tamaño de la pantalla
+    float blue;           // Componente z del patrón (sólo depende del tiempo)
+};
+
+// Caché de la etapa de color, reutilizada entre cuadros
+struct ShadingCache {
+    ShadeMode mode = ShadeMode::Exact;
+    float time = 0.0f;             // Instante de los valores en caché
+    vec2 bounds = vec2(0.0f);      // Pantalla de los valores en caché
+    bool uniformsReady = false;    // Los uniformes corresponden a time y bounds
+    ShadeUniforms uniforms;
+    vector<uint32_t> lut;          // SHADE_LUT_RADII filas de SHADE_LUT_POSITIONS colores con azul 0 (vacía hasta usarla)
+};
+
+// Término del patrón que sólo depende del tiempo (el bucle original de 10000 pasos)
+float patternBlue(const float time);
+
+// Uniformes del instante dado; se calculan la primera vez que se piden para ese instante
+const ShadeUniforms& shadeUniforms(ShadingCache& cache, const vec2& bounds, const float time);
+
+// Calcula el color empaquetado de todas las partículas
+void shadeParticles(ParticleSystem& particles, ShadingCache& cache, const vec2& bounds, const float time);
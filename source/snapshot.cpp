@@ -0,0 +1,125 @@
+#include "snapshot.hpp"
+
+// Identificador al inicio del archivo
+static const char SNAPSHOT_MAGIC[8] = { 'P', 'A', 'R', 'S', 'N', 'A', 'P', '\0' };
+
+// Redondea hacia arriba a la granularidad de proyección
+static inline uint64_t alignToMap(const uint64_t bytes) {
+    return (bytes + ARENA_MAP_GRANULARITY - 1) / ARENA_MAP_GRANULARITY * ARENA_MAP_GRANULARITY;
+}
+
+// Arreglos de un sistema de partículas en el orden del formato
+static array<const char*, PARTICLE_FIELDS> fieldPointers(const ParticleSystem& particles) {
+    return {
+        reinterpret_cast<const char*>(particles.positionX), reinterpret_cast<const char*>(particles.positionY),
+        reinterpret_cast<const char*>(particles.velocityX), reinterpret_cast<const char*>(particles.velocityY),
+        reinterpret_cast<const char*>(particles.displayRadius), reinterpret_cast<const char*>(particles.radius),
+        reinterpret_cast<const char*>(particles.mass), reinterpret_cast<const char*>(particles.color)
+    };
+}
+
+void saveSnapshot(const Scene& scene, const string& path) {
+    const ParticleSystem& particles = scene.particles;
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.fieldCount = uint32_t(PARTICLE_FIELDS);
+    header.count = particles.count;
+    header.fieldBytes = std::max<uint64_t>(alignToMap(particles.padded() * sizeof(float)), ARENA_MAP_GRANULARITY);
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        header.fieldOffset[f] = alignToMap(sizeof(SnapshotHeader)) + f * header.fieldBytes;
+    }
+    header.boundsX = scene.bounds.x;
+    header.boundsY = scene.bounds.y;
+    header.time = scene.time;
+    header.frame = scene.frame;
+    header.randomSeed = scene.random.seed;
+    header.randomCounter = scene.random.counter;
+
+    // Se escribe en un archivo temporal y se renombra al final: la escena puede tener proyectado
+    // el archivo de destino (truncarlo borraría sus páginas) y un fallo no deja el destino a medias
+    const string temporary = path + ".tmp";
+    std::error_code error;
+    auto fail = [&](const string& reason) {
+        std::filesystem::remove(temporary, error);
+        throw runtime_error("No se pudo escribir " + path + reason);
+    };
+
+    // Cabecera y tamaño final; los huecos entre campos quedan a cero
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) fail("");
+    }
+    std::filesystem::resize_file(temporary, header.fieldOffset[PARTICLE_FIELDS - 1] + header.fieldBytes, error);
+    if (error) fail(": " + error.message());
+
+    // Cada hilo escribe campos completos con su propio flujo sobre el mismo archivo
+    const array<const char*, PARTICLE_FIELDS> fields = fieldPointers(particles);
+    const streamsize bytes = streamsize(particles.padded() * sizeof(float));
+    int failures = 0;
+
+    #pragma omp parallel for reduction(+:failures)
+    for (int f = 0; f < int(PARTICLE_FIELDS); ++f) {
+        fstream out(temporary, ios::binary | ios::in | ios::out);
+        out.seekp(streamoff(header.fieldOffset[f]));
+        out.write(fields[f], bytes);
+        out.flush();
+        failures += out ? 0 : 1;
+    }
+    if (failures > 0) fail("");
+
+    // Un archivo proyectado sigue vivo tras el reemplazo hasta que se libera la proyección
+    std::filesystem::rename(temporary, path, error);
+    if (error) fail(": " + error.message());
+}
+
+void loadSnapshot(Scene& scene, const string& path) {
+    MappableFile file(path);
+
+    SnapshotHeader header;
+    {
+        ifstream in(path, ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in) throw runtime_error("Instantánea incompleta: " + path);
+    }
+
+    // Comprueba el formato antes de proyectar nada
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error("No es una instantánea: " + path);
+    }
+    if (header.version != SNAPSHOT_VERSION || header.fieldCount != PARTICLE_FIELDS) {
+        throw runtime_error("Versión de instantánea no compatible (" + to_string(header.version) + "): " + path);
+    }
+    // Se compara por división: count * 4 o offset + bytes podrían desbordar con una cabecera dañada
+    if (header.fieldBytes == 0 || header.fieldBytes % ARENA_MAP_GRANULARITY != 0 || header.count > header.fieldBytes / sizeof(float) ||
+        header.boundsX < 1.0f || header.boundsY < 1.0f || header.boundsX > 65535.0f || header.boundsY > 65535.0f) {
+        throw runtime_error("Instantánea dañada: " + path);
+    }
+    if (header.fieldBytes / sizeof(float) > scene.particles.maxCapacity) {
+        throw runtime_error("Demasiadas partículas en " + path + ": " + to_string(header.count) + " (máximo " + to_string(scene.particles.maxCapacity) + ")");
+    }
+    for (size_t f = 0; f < PARTICLE_FIELDS; ++f) {
+        // Los campos van después de la cabecera; nunca se proyecta la cabecera como campo
+        if (header.fieldOffset[f] % ARENA_MAP_GRANULARITY != 0 || header.fieldOffset[f] < alignToMap(sizeof(SnapshotHeader)) ||
+            header.fieldOffset[f] > file.size() || header.fieldBytes > file.size() - header.fieldOffset[f]) {
+            throw runtime_error("Instantánea dañada: " + path);
+        }
+    }
+
+    // Proyecta en un sistema nuevo y sólo entonces reemplaza el de la escena
+    ParticleSystem particles(0, scene.particles.maxCapacity);
+    particles.mapFields(file, header.fieldOffset, size_t(header.fieldBytes), size_t(header.count));
+    scene.particles = std::move(particles);
+
+    const uint16_t resx = uint16_t(header.boundsX);
+    const uint16_t resy = uint16_t(header.boundsY);
+    scene.bounds = vec2(header.boundsX, header.boundsY);
+    if (scene.framebuffer.width != resx || scene.framebuffer.height != resy) {
+        scene.framebuffer = Framebuffer(resx, resy);
+    }
+    scene.time = header.time;
+    scene.frame = header.frame;
+    scene.random = CounterRng(header.randomSeed, header.randomCounter);
+}
@@ -0,0 +1,40 @@
+/**
+ * snapshot.hpp
+ * Instantánea binaria del estado de la simulación
+ *
+ * Guarda las partículas, el tiempo simulado y el estado del generador
+ * aleatorio en un archivo versionado. Cada campo ocupa un bloque alineado
+ * a ARENA_MAP_GRANULARITY, de modo que al cargar los arreglos se proyectan
+ * directamente desde el archivo (sin leerlos ni copiarlos) y se escriben
+ * en paralelo, un campo por hilo. El formato es little-endian.
+ */
+
+#pragma once
+#include "scene.hpp"
+
+// Versión actual del formato
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// Cabecera al inicio del archivo (ocupa el primer bloque alineado)
+struct SnapshotHeader {
+    char magic[8];                          // "PARSNAP" y un cero
+    uint32_t version;                       // SNAPSHOT_VERSION
+    uint32_t fieldCount;                    // PARTICLE_FIELDS
+    uint64_t count;                         // Partículas
+    uint64_t fieldBytes;                    // Bytes reservados por campo (múltiplo de ARENA_MAP_GRANULARITY)
+    uint64_t fieldOffset[PARTICLE_FIELDS];  // Inicio de cada campo, en el orden de ParticleSystem
+    float boundsX;                          // Tamaño de la pantalla
+    float boundsY;
+    double time;                            // Tiempo simulado en segundos
+    uint64_t frame;                         // Cuadros simulados
+    uint64_t randomSeed;                    // Estado del generador de partículas
+    uint64_t randomCounter;
+};
+
+// Escribe el estado de la escena en un temporario que luego reemplaza a path, así que se puede guardar
+// sobre la instantánea de la que se cargó la escena (lanza runtime_error si falla la escritura)
+void saveSnapshot(const Scene& scene, const string& path);
+
+// Carga el estado en la escena proyectando los arreglos desde el archivo; ajusta bounds y el
+// búfer al tamaño guardado (lanza runtime_error si el archivo no es válido)
+void loadSnapshot(Scene& scene, const string& path);
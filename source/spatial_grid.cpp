@@ -0,0 +1,179 @@
+#include "spatial_grid.hpp"
+#include "particles.hpp"
+#include "trace.hpp"
+
+// Calcula la celda que contiene una posición, acotada a la rejilla
+static inline uint32_t cellOf(const SpatialGrid& grid, const float x, const float y) {
+    const int cx = glm::clamp(int(x / grid.cellSize), 0, grid.cols - 1);
+    const int cy = glm::clamp(int(y / grid.cellSize), 0, grid.rows - 1);
+    return uint32_t(cy * grid.cols + cx);
+}
+
+// Reconstruye la rejilla con un ordenamiento por conteo en paralelo
+void buildSpatialGrid(SpatialGrid& grid, const ParticleSystem& particles, const vec2& bounds) {
+    const int count = int(particles.count);
+
+    const int numThreads = omp_get_max_threads();
+
+    // El tamaño de celda depende del radio máximo del cuadro (máximo parcial por hilo)
+    vector<float> partialMax(numThreads, 0.0f);
+    #pragma omp parallel num_threads(numThreads)
+    {
+        float localMax = 0.0f;
+        #pragma omp for
+        for (int i = 0; i < count; ++i) {
+            localMax = std::max(localMax, particles.radius[i]);
+        }
+        partialMax[omp_get_thread_num()] = localMax;
+    }
+    const float maxRadius = *std::max_element(partialMax.begin(), partialMax.end());
+
+    grid.cellSize = std::max(2.0f * maxRadius, 1.0f);
+    grid.cols = std::max(int(ceil(bounds.x / grid.cellSize)), 1);
+    grid.rows = std::max(int(ceil(bounds.y / grid.cellSize)), 1);
+
+    const int numCells = grid.cols * grid.rows;
+
+    grid.cellStart.assign(numCells + 1, 0);
+    grid.cellEntries.resize(count);
+    grid.particleCell.resize(count);
+    grid.threadCounts.assign(size_t(numThreads) * numCells, 0);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+        TRACE_ZONE("grid.thread");
+
+        // Cada hilo procesa siempre el mismo bloque contiguo de partículas
+        const int thread = omp_get_thread_num();
+        const int threads = omp_get_num_threads();
+        const int begin = int(int64_t(count) * thread / threads);
+        const int end = int(int64_t(count) * (thread + 1) / threads);
+        uint32_t* counts = &grid.threadCounts[size_t(thread) * numCells];
+
+        // Histograma local de partículas por celda
+        for (int i = begin; i < end; ++i) {
+            const uint32_t cell = cellOf(grid, particles.positionX[i], particles.positionY[i]);
+            grid.particleCell[i] = cell;
+            counts[cell]++;
+        }
+
+        // Espera a que todos los hilos terminen su histograma
+        {
+            TRACE_WAIT("grid.barrier");
+            #pragma omp barrier
+        }
+
+        // Total de partículas por celda
+        #pragma omp for
+        for (int cell = 0; cell < numCells; ++cell) {
+            uint32_t total = 0;
+            for (int t = 0; t < threads; ++t) {
+                total += grid.threadCounts[size_t(t) * numCells + cell];
+            }
+            grid.cellStart[cell + 1] = total;
+        }
+
+        // Suma de prefijos sobre las celdas
+        #pragma omp single
+        for (int cell = 0; cell < numCells; ++cell) {
+            grid.cellStart[cell + 1] += grid.cellStart[cell];
+        }
+
+        // Desplazamiento de cada hilo dentro de cada celda
+        #pragma omp for
+        for (int cell = 0; cell < numCells; ++cell) {
+            uint32_t offset = grid.cellStart[cell];
+            for (int t = 0; t < threads; ++t) {
+                uint32_t& slot = grid.threadCounts[size_t(t) * numCells + cell];
+                const uint32_t c = slot;
+                slot = offset;
+                offset += c;
+            }
+        }
+
+        // Dispersión sin conflictos: cada hilo escribe en sus propias posiciones
+        for (int i = begin; i < end; ++i) {
+            grid.cellEntries[counts[grid.particleCell[i]]++] = uint32_t(i);
+        }
+    }
+}
+
+// Resuelve un par en contacto: impulso elástico igual y opuesto y separación según la masa
+static inline void resolvePair(ParticleSystem& particles, const uint32_t i, const uint32_t j) {
+    const vec2 offset = vec2(particles.positionX[i] - particles.positionX[j], particles.positionY[i] - particles.positionY[j]);
+    const float distanceSq = dot(offset, offset);
+    const float minDistance = particles.radius[i] + particles.radius[j];
+    if (distanceSq >= minDistance * minDistance || distanceSq < 1e-8f) return;
+
+    const float distance = sqrt(distanceSq);
+    const vec2 normal = offset / distance;
+    const float massI = particles.mass[i];
+    const float massJ = particles.mass[j];
+    const float shareI = massJ / (massI + massJ);
+    const float shareJ = massI / (massI + massJ);
+
+    // Impulso sólo si las partículas se acercan; conserva momento y energía del par
+    const float approach = (particles.velocityX[i] - particles.velocityX[j]) * normal.x + (particles.velocityY[i] - particles.velocityY[j]) * normal.y;
+    if (approach < 0.0f) {
+        const vec2 deltaI = normal * (2.0f * shareI * approach);
+        const vec2 deltaJ = normal * (2.0f * shareJ * approach);
+        particles.velocityX[i] -= deltaI.x;
+        particles.velocityY[i] -= deltaI.y;
+        particles.velocityX[j] += deltaJ.x;
+        particles.velocityY[j] += deltaJ.y;
+    }
+
+    // Separa la superposición sin mover el centro de masa del par
+    const float overlap = minDistance - distance;
+    particles.positionX[i] += normal.x * (overlap * shareI);
+    particles.positionY[i] += normal.y * (overlap * shareI);
+    particles.positionX[j] -= normal.x * (overlap * shareJ);
+    particles.positionY[j] -= normal.y * (overlap * shareJ);
+}
+
+// Resuelve los pares cuya primera partícula está en la celda (cada par una sola vez)
+static inline void resolveCell(ParticleSystem& particles, const SpatialGrid& grid, const int cx, const int cy) {
+    const int cell = cy * grid.cols + cx;
+    const int minX = std::max(cx - 1, 0), maxX = std::min(cx + 1, grid.cols - 1);
+    const int minY = std::max(cy - 1, 0), maxY = std::min(cy + 1, grid.rows - 1);
+
+    for (uint32_t a = grid.cellStart[cell]; a < grid.cellStart[cell + 1]; ++a) {
+        const uint32_t i = grid.cellEntries[a];
+
+        // En la propia celda sólo las siguientes; de las vecinas, sólo las de índice mayor
+        for (uint32_t b = a + 1; b < grid.cellStart[cell + 1]; ++b) {
+            resolvePair(particles, i, grid.cellEntries[b]);
+        }
+        for (int ny = minY; ny <= maxY; ++ny) {
+            for (int nx = minX; nx <= maxX; ++nx) {
+                const int neighbor = ny * grid.cols + nx;
+                if (neighbor <= cell) continue;
+                for (uint32_t b = grid.cellStart[neighbor]; b < grid.cellStart[neighbor + 1]; ++b) {
+                    resolvePair(particles, i, grid.cellEntries[b]);
+                }
+            }
+        }
+    }
+}
+
+// Resuelve colisiones elásticas coloreando las celdas en 9 grupos: dos celdas del mismo color
+// están al menos a 3 celdas, así que sus vecindarios no se tocan y se procesan en paralelo sin
+// conflictos. Cada par recibe impulsos iguales y opuestos, aplicados uno tras otro.
+void resolveCircleCollisions(ParticleSystem& particles, const SpatialGrid& grid) {
+    #pragma omp parallel
+    {
+        for (int color = 0; color < 9; ++color) {
+            const int offsetX = color % 3;
+            const int offsetY = color / 3;
+            const int colorCols = (grid.cols - offsetX + 2) / 3;
+            const int colorRows = (grid.rows - offsetY + 2) / 3;
+            const int colorCells = colorCols * colorRows;
+
+            // La barrera implícita separa los colores
+            #pragma omp for schedule(dynamic, 16)
+            for (int k = 0; k < colorCells; ++k) {
+                resolveCell(particles, grid, offsetX + (k % colorCols) * 3, offsetY + (k / colorCols) * 3);
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * spatial_grid.hpp
+ * Rejilla espacial uniforme para colisiones entre partículas
+ *
+ * Agrupa las partículas en celdas del tamaño del diámetro máximo,
+ * de modo que cada partícula sólo se compara con las de su celda
+ * y las 8 vecinas. La rejilla se reconstruye en paralelo cada cuadro y
+ * las colisiones se resuelven por colores de celda, sin candados.
+ */
+
+#pragma once
+#include "include.hpp"
+
+struct ParticleSystem;
+
+// Rejilla de celdas uniforme construida por ordenamiento por conteo
+struct SpatialGrid {
+    float cellSize = 1.0f;          // Lado de cada celda (2 * radio máximo)
+    int cols = 0;                   // Número de columnas
+    int rows = 0;                   // Número de filas
+    vector<uint32_t> cellStart;     // Inicio de cada celda en cellEntries (cols * rows + 1)
+    vector<uint32_t> cellEntries;   // Índices de partículas ordenados por celda
+    vector<uint32_t> particleCell;  // Celda asignada a cada partícula
+    vector<uint32_t> threadCounts;  // Histogramas por hilo (hilos * celdas)
+};
+
+// Reconstruye la rejilla con las posiciones actuales de las partículas
+void buildSpatialGrid(SpatialGrid& grid, const ParticleSystem& particles, const vec2& bounds);
+
+// Resuelve colisiones elásticas entre partículas usando la rejilla (conserva momento y energía)
+void resolveCircleCollisions(ParticleSystem& particles, const SpatialGrid& grid);
@@ -0,0 +1,161 @@
+#include "trace.hpp"
+
+#ifdef PARALELA_TRACE
+
+#include <mutex>
+
+// Eventos por bloque del búfer de un hilo
+static constexpr size_t TRACE_CHUNK_EVENTS = 65536;
+
+// Bloques máximos por hilo (los eventos posteriores se descartan y se cuentan)
+static constexpr size_t TRACE_MAX_CHUNKS = 256;
+
+// Búfer de un hilo: sólo su dueño escribe; el exportador lee hasta count
+struct TraceBuffer {
+    uint32_t thread = 0;
+    string name;
+    std::atomic<size_t> count{0};
+    array<std::atomic<TraceEvent*>, TRACE_MAX_CHUNKS> chunks{};
+    uint64_t dropped = 0;
+
+    ~TraceBuffer() {
+        for (std::atomic<TraceEvent*>& chunk : chunks) delete[] chunk.load();
+    }
+};
+
+// Registro de búferes: se toma el candado sólo al crear un búfer, nombrarlo o exportar
+static std::mutex registryMutex;
+static vector<unique_ptr<TraceBuffer>> registry;
+static thread_local TraceBuffer* localBuffer = nullptr;
+
+// Búfer del hilo actual (se crea la primera vez)
+static TraceBuffer& threadBuffer() {
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(make_unique<TraceBuffer>());
+        localBuffer = registry.back().get();
+        localBuffer->thread = uint32_t(registry.size());
+        localBuffer->name = "hilo " + to_string(localBuffer->thread);
+    }
+    return *localBuffer;
+}
+
+void traceRecord(const char* name, const uint64_t start, const uint64_t end, const TraceKind kind) {
+    TraceBuffer& buffer = threadBuffer();
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    const size_t chunk = index / TRACE_CHUNK_EVENTS;
+    if (chunk >= TRACE_MAX_CHUNKS) {
+        buffer.dropped++;
+        return;
+    }
+
+    TraceEvent* events = buffer.chunks[chunk].load(std::memory_order_relaxed);
+    if (!events) {
+        events = new TraceEvent[TRACE_CHUNK_EVENTS];
+        buffer.chunks[chunk].store(events, std::memory_order_release);
+    }
+    events[index % TRACE_CHUNK_EVENTS] = { name, start, end - start, kind };
+
+    // Publica el evento para el exportador
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void traceThreadName(const char* name) {
+    TraceBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+bool writeChromeTrace(const string& path) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ofstream out(path);
+    if (!out) return false;
+
+    // Los tiempos se escriben en microsegundos desde el evento más antiguo
+    // (una zona se registra al cerrarse, así que el primero del búfer no siempre es el más antiguo)
+    uint64_t origin = UINT64_MAX;
+    for (const unique_ptr<TraceBuffer>& buffer : registry) {
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            origin = std::min(origin, buffer->chunks[i / TRACE_CHUNK_EVENTS].load(std::memory_order_acquire)[i % TRACE_CHUNK_EVENTS].start);
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    out << fixed << setprecision(3);
+    for (const unique_ptr<TraceBuffer>& buffer : registry) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread
+            << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+        first = false;
+
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->chunks[i / TRACE_CHUNK_EVENTS].load(std::memory_order_acquire)[i % TRACE_CHUNK_EVENTS];
+            out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << (event.kind == TraceKind::Wait ? "wait" : "zone")
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread
+                << ",\"ts\":" << double(event.start - origin) / 1000.0 << ",\"dur\":" << double(event.duration) / 1000.0 << "}";
+        }
+        if (buffer->dropped > 0) {
+            cerr << "Traza: " << buffer->name << " descartó " << buffer->dropped << " eventos\n";
+        }
+    }
+    out << "\n]}\n";
+    return bool(out);
+}
+
+void recordFrameTime(FrameStats& stats, const float seconds) {
+    stats.samples[stats.next] = seconds;
+    stats.next = (stats.next + 1) % TRACE_OVERLAY_FRAMES;
+    stats.filled = std::min(stats.filled + 1, TRACE_OVERLAY_FRAMES);
+}
+
+vec3 framePercentiles(const FrameStats& stats) {
+    if (stats.filled == 0) return vec3(0.0f);
+
+    array<float, TRACE_OVERLAY_FRAMES> sorted = stats.samples;
+    std::sort(sorted.begin(), sorted.begin() + stats.filled);
+    auto percentile = [&](const float p) {
+        return sorted[std::min(int(p * float(stats.filled)), stats.filled - 1)] * 1000.0f;
+    };
+    return vec3(percentile(0.50f), percentile(0.95f), percentile(0.99f));
+}
+
+void drawFrameOverlay(Framebuffer& framebuffer, const FrameStats& stats) {
+    // Gráfica en la esquina inferior izquierda: 1 px por cuadro, 2 px por milisegundo
+    constexpr int GRAPH_HEIGHT = 80;
+    constexpr float PIXELS_PER_MS = 2.0f;
+    const int left = 8;
+    const int bottom = int(framebuffer.height) - 8;
+    if (bottom - GRAPH_HEIGHT < 0 || left + TRACE_OVERLAY_FRAMES > int(framebuffer.width)) return;
+
+    // Fondo oscurecido
+    for (int y = bottom - GRAPH_HEIGHT; y < bottom; ++y) {
+        for (int x = left; x < left + TRACE_OVERLAY_FRAMES; ++x) {
+            uint32_t& pixel = framebuffer.pixels[size_t(y) * framebuffer.width + x];
+            pixel = 0xFF000000u | ((pixel >> 2) & 0x003F3F3Fu);
+        }
+    }
+
+    // Barras del cuadro más antiguo (izquierda) al más reciente (derecha)
+    for (int k = 0; k < stats.filled; ++k) {
+        const int sample = (stats.next - stats.filled + k + TRACE_OVERLAY_FRAMES) % TRACE_OVERLAY_FRAMES;
+        const int height = std::min(int(stats.samples[sample] * 1000.0f * PIXELS_PER_MS), GRAPH_HEIGHT);
+        const int x = left + TRACE_OVERLAY_FRAMES - stats.filled + k;
+        for (int y = bottom - height; y < bottom; ++y) {
+            framebuffer.pixels[size_t(y) * framebuffer.width + x] = 0xFFC0C0C0u;
+        }
+    }
+
+    // Líneas de percentiles
+    const vec3 percentiles = framePercentiles(stats);
+    const uint32_t colors[3] = { 0xFF40FF40u, 0xFFFFFF40u, 0xFFFF4040u };
+    for (int p = 0; p < 3; ++p) {
+        const int y = bottom - 1 - std::min(int(percentiles[p] * PIXELS_PER_MS), GRAPH_HEIGHT - 1);
+        for (int x = left; x < left + TRACE_OVERLAY_FRAMES; ++x) {
+            framebuffer.pixels[size_t(y) * framebuffer.width + x] = colors[p];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * trace.hpp
+ * Instrumentación por zonas con exportación a Chrome trace_event
+ *
+ * TRACE_ZONE mide el bloque en el que se declara y TRACE_WAIT marca el
+ * tiempo bloqueado esperando a otro hilo. Cada hilo escribe en su propio
+ * búfer sin candados; al final se vuelca todo a un JSON que abren
+ * chrome://tracing o Perfetto. Sin PARALELA_TRACE las macros no generan
+ * ningún código.
+ */
+
+#pragma once
+#include "include.hpp"
+
+#ifdef PARALELA_TRACE
+
+#include "framebuffer.hpp"
+
+// Tipo de evento: trabajo o espera
+enum class TraceKind : uint8_t {
+    Zone,
+    Wait
+};
+
+// Evento completo (inicio y duración en nanosegundos del reloj monótono)
+struct TraceEvent {
+    const char* name;       // Literal de cadena: no se copia
+    uint64_t start;
+    uint64_t duration;
+    TraceKind kind;
+};
+
+// Reloj de las zonas en nanosegundos
+inline uint64_t traceNow() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Añade un evento al búfer del hilo actual
+void traceRecord(const char* name, const uint64_t start, const uint64_t end, const TraceKind kind);
+
+// Nombre del hilo actual en la traza
+void traceThreadName(const char* name);
+
+// Escribe todos los eventos en formato Chrome trace_event; devuelve false si no pudo escribir
+bool writeChromeTrace(const string& path);
+
+// Mide el bloque que la contiene
+struct TraceZone {
+    const char* name;
+    TraceKind kind;
+    uint64_t start;
+
+    TraceZone(const char* name, const TraceKind kind = TraceKind::Zone) : name(name), kind(kind), start(traceNow()) {}
+    ~TraceZone() { traceRecord(name, start, traceNow(), kind); }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_WAIT(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name, TraceKind::Wait)
+#define TRACE_THREAD(name) traceThreadName(name)
+
+// Cuadros que recuerda el indicador en pantalla
+constexpr int TRACE_OVERLAY_FRAMES = 240;
+
+// Tiempos de cuadro recientes para los percentiles
+struct FrameStats {
+    array<float, TRACE_OVERLAY_FRAMES> samples{};   // Segundos, en anillo
+    int next = 0;
+    int filled = 0;
+};
+
+// Añade el tiempo de un cuadro (segundos)
+void recordFrameTime(FrameStats& stats, const float seconds);
+
+// Percentiles 50, 95 y 99 de los cuadros recientes, en milisegundos
+vec3 framePercentiles(const FrameStats& stats);
+
+// Dibuja la gráfica de tiempos de cuadro con líneas en p50 (verde), p95 (amarillo) y p99 (rojo)
+void drawFrameOverlay(Framebuffer& framebuffer, const FrameStats& stats);
+
+#else
+
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_WAIT(name) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+
+#endif